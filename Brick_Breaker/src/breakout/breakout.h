@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "breakout_pool.h"
 
 /* ============================================================================
  * SCREEN CONSTANTS
@@ -35,10 +36,19 @@
 #define MAX_PLAYERS 2
 
 // Ball system - we support multi-ball power-up
-#define MAX_BALLS 5
+#define MAX_BALLS 512       // Balls in play at once (ball storm mode)
+#define MULTIBALL_BALLS 5   // Multi-ball fills up to this many in a normal game
 #define BALL_SIZE 4
 #define BALL_SPEED 2
 
+// Ball storm mode: every life starts with this many balls, and bricks
+// take this many times their usual hits. The levels repeat until ESC.
+#define STORM_BALLS 500
+#define STORM_BRICK_HITS 40
+
+// Motion trail: each ball's last few positions, one per tick
+#define BALL_TRAIL_LENGTH 8   // Power of two
+
 // Paddle settings
 #define PADDLE_WIDTH 40
 #define PADDLE_HEIGHT 8
@@ -52,6 +62,22 @@
 #define BRICK_ROWS 5
 #define BRICK_COLS 12
 #define BRICK_START_Y 30  // Top margin before bricks start
+#define BRICK_START_X 5   // Left margin before bricks start
+#define BRICK_GAP 2       // Space between neighbouring bricks
+
+// Distance from one brick to the next, and a brick's top-left corner
+#define BRICK_STEP_X (BRICK_WIDTH + BRICK_GAP)
+#define BRICK_STEP_Y (BRICK_HEIGHT + BRICK_GAP)
+#define BRICK_X(col) ((col) * BRICK_STEP_X + BRICK_START_X)
+#define BRICK_Y(row) ((row) * BRICK_STEP_Y + BRICK_START_Y)
+
+// Standing bricks are also kept as one bit per column, in 32-bit words, so
+// the grid can grow past 32 columns
+#define BRICK_WORD_BITS 32
+#define BRICK_WORDS ((BRICK_COLS + BRICK_WORD_BITS - 1) / BRICK_WORD_BITS)
+
+// Lowest set bit of a non-zero word (compiles to a single bsf/tzcnt)
+#define BRICK_BIT_SCAN(bits) __builtin_ctz(bits)
 
 // Power-up system
 #define MAX_POWERUPS 10
@@ -59,12 +85,63 @@
 #define POWERUP_FALL_SPEED 2
 
 // Visual effects
-#define MAX_PARTICLES 100  // For explosion effects
+#define MAX_PARTICLES 2048 // For explosion effects and debris
 #define MAX_LASERS 10      // Laser beams per player
 
 // Game has 4 levels
 #define MAX_LEVELS 4
 
+/* ============================================================================
+ * FIXED-POINT MATH
+ * ============================================================================
+ * Ball positions and velocities are 16.16 fixed point: the top 16 bits are
+ * whole pixels, the bottom 16 bits are fractions of a pixel. This lets a
+ * ball move 1.5 pixels per frame, or half its speed, without rounding away.
+ */
+typedef int32_t fixed_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define INT_TO_FIXED(v) ((fixed_t)(v) * FIXED_ONE)
+#define FIXED_TO_INT(v) ((int)((v) >> FIXED_SHIFT))   // Rounds down
+
+/* ============================================================================
+ * SIMULATION TIMING
+ * ============================================================================
+ * The game is simulated in fixed steps of 1/SIM_RATE_HZ seconds, no matter
+ * how fast frames are drawn. Speeds and timers are tuned in 60 Hz "ticks":
+ * at higher rates the balls move in SIM_SUBSTEPS smaller steps per tick
+ * (finer collisions), and everything else still advances once per tick.
+ * Build with e.g. make SIM_RATE=240.
+ */
+#ifndef SIM_RATE_HZ
+#define SIM_RATE_HZ 120
+#endif
+
+#define SIM_TICK_HZ 60
+#define SIM_SUBSTEPS (SIM_RATE_HZ / SIM_TICK_HZ)
+#define SIM_STEP_COST 1000    // Clock units per step (1 ms = SIM_RATE_HZ units)
+
+#if SIM_RATE_HZ % SIM_TICK_HZ != 0
+#error "SIM_RATE_HZ must be a multiple of 60"
+#endif
+
+// Most steps run per drawn frame; a slow frame drops time beyond this
+// instead of needing ever more steps to catch up
+#define SIM_MAX_STEPS (SIM_SUBSTEPS * 4)
+
+// Render blend between the previous and current step (0 to SIM_BLEND_FULL)
+#define SIM_BLEND_FULL 256
+
+/* ============================================================================
+ * GAME MODES
+ * ============================================================================
+ */
+typedef enum {
+    GAME_MODE_CLASSIC = 0,  // 1 or 2 players, one ball (multi-ball up to 5)
+    GAME_MODE_STORM         // Hundreds of balls at once (1 player)
+} game_mode_t;
+
 /* ============================================================================
  * POWER-UP TYPES
  * ============================================================================
@@ -91,20 +168,20 @@ typedef enum {
 /**
  * ball_t - Represents a single ball in play
  * 
- * The game can have up to MAX_BALLS active at once (multi-ball power-up).
- * Each ball tracks its position, velocity, and motion trail.
+ * The game can have up to MAX_BALLS active at once (multi-ball power-up,
+ * ball storm). Each ball tracks its position and velocity; its motion
+ * trail is kept apart in game.ball_trails, as only drawing needs it.
  */
 typedef struct {
-    int x, y;              // Current position on screen
-    int dx, dy;            // Velocity (direction and speed)
+    fixed_t x, y;          // Current position (16.16 fixed point)
+    fixed_t prev_x, prev_y;  // Position one step ago (for drawing between steps)
+    fixed_t dx, dy;        // Velocity in pixels per tick (16.16 fixed point)
     bool active;           // Is this ball currently in play?
-    
-    // Motion trail effect - stores last 10 positions
-    uint8_t trail_x[10];
-    uint8_t trail_y[10];
-    int trail_index;       // Current position in circular buffer
+    uint16_t pool_link;    // Used by the ball pool
 } ball_t;
 
+POOL_DEFINE(ball_pool, ball_t, MAX_BALLS)
+
 /**
  * brick_t - Represents a single brick in the grid
  * 
@@ -127,22 +204,28 @@ typedef struct {
     int x, y;              // Current position
     powerup_type_t type;   // Which power-up is this?
     bool active;           // Is it currently falling?
+    uint16_t pool_link;    // Used by the power-up pool
     uint8_t color;         // Display color (different per type)
 } powerup_t;
 
+POOL_DEFINE(powerup_pool, powerup_t, MAX_POWERUPS)
+
 /**
- * particle_t - A single particle for explosion effects
+ * particle_pool_t - All live particles, for explosion effects
  * 
  * When bricks break, we spawn 8 particles that spray outward with physics.
- * Each particle has a lifetime and fades out.
+ * Each particle has a lifetime and fades out. The particles are stored as
+ * one array per field, with the live ones packed into [0, count): a new
+ * particle goes on the end, and a dead one is replaced by the last one.
+ * The update loop then runs straight down plain arrays (and vectorizes).
  */
 typedef struct {
-    int x, y;              // Position
-    int dx, dy;            // Velocity
-    uint8_t color;         // Color
-    int life;              // Frames remaining (particle dies when this hits 0)
-    bool active;           // Is this particle alive?
-} particle_t;
+    int16_t x[MAX_PARTICLES], y[MAX_PARTICLES];     // Position
+    int16_t dx[MAX_PARTICLES], dy[MAX_PARTICLES];   // Velocity
+    int16_t life[MAX_PARTICLES];   // Frames remaining (particle dies at 0)
+    uint8_t color[MAX_PARTICLES];  // Color
+    int count;                     // Live particles
+} particle_pool_t;
 
 /**
  * laser_t - A laser projectile
@@ -153,8 +236,11 @@ typedef struct {
 typedef struct {
     int x, y;              // Position
     bool active;           // Is this laser flying?
+    uint16_t pool_link;    // Used by the laser pool
 } laser_t;
 
+POOL_DEFINE(laser_pool, laser_t, MAX_LASERS)
+
 /**
  * player_t - One player's complete state
  * 
@@ -174,7 +260,7 @@ typedef struct {
     // Laser power-up state
     bool has_laser;        // Can the player shoot?
     int laser_cooldown;    // Frames until can shoot again
-    laser_t lasers[MAX_LASERS];
+    laser_pool_t lasers;
     
     // Turn-based multiplayer
     bool turn_complete;    // Has this player finished their turn?
@@ -190,6 +276,7 @@ typedef struct {
     uint8_t colors[BRICK_ROWS];                // Color for each row
     int ball_speed;                             // How fast the ball moves
     char* name;                                 // Level name for display
+    char* song;                                 // Music file (see sound/music.h)
 } level_t;
 
 /**
@@ -197,18 +284,32 @@ typedef struct {
  * 
  * This is THE main structure that holds everything about the current game.
  * All the game files access this to update and render the game.
+ * 
+ * Everything from `particles` on is presentation only: it never feeds back
+ * into the simulation, headless replays skip it, and the replay checksum
+ * stops in front of it.
  */
 typedef struct {
+    game_mode_t mode;      // Classic or ball storm
+    
     // Players (1 or 2)
     player_t players[MAX_PLAYERS];
     int num_players;
     int current_player;    // Whose turn? (0 or 1)
     
     // Active game objects
-    ball_t balls[MAX_BALLS];
+    ball_pool_t balls;
+    
+    // Trail of each ball slot: screen offsets (y * VGA_WIDTH + x), a ring
+    // shared by all balls with the newest point at trail_head
+    uint16_t ball_trails[MAX_BALLS][BALL_TRAIL_LENGTH];
+    uint8_t trail_head;
+    bool ball_collisions;  // Do balls bounce off each other?
+    
     brick_t bricks[BRICK_ROWS][BRICK_COLS];
-    powerup_t powerups[MAX_POWERUPS];
-    particle_t particles[MAX_PARTICLES];
+    uint32_t brick_bits[BRICK_ROWS][BRICK_WORDS];  // Bit set = brick standing
+    int bricks_left;                               // Standing bricks in total
+    powerup_pool_t powerups;
     
     // Game progression
     int level;             // Current level (0-3)
@@ -218,14 +319,17 @@ typedef struct {
     // Power-up effects
     int ball_speed_multiplier;  // -1 = slow, 0 = normal, 1 = fast
     
-    // Visual effects
-    int screen_shake_timer;
-    int screen_shake_x, screen_shake_y;
+    // Fixed-step simulation
+    uint32_t sim_steps;    // Steps run so far (a tick starts every SIM_SUBSTEPS)
     
     // Audio state
     bool sound_enabled;
-    int music_note;        // Current note in melody
-    int music_timer;       // Timer for background music
+    
+    // Visual effects (presentation only from here on)
+    particle_pool_t particles;
+    int screen_shake_timer;
+    int screen_shake_x, screen_shake_y;
+    int sim_blend;         // How far drawing is between the last two steps
 } game_state_t;
 
 /* ============================================================================
@@ -235,8 +339,9 @@ typedef struct {
  */
 
 // Main game functions (in breakout_main.c)
-void breakout_init(int num_players);
+void breakout_init(int num_players, game_mode_t mode);
 void breakout_run();
+bool breakout_step();   // One fixed simulation step (true = level cleared)
 
 // Helper functions that various files will need
 void play_sound(int frequency, int duration_ms);
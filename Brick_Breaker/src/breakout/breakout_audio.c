@@ -9,106 +9,147 @@
  * - The Programmable Interval Timer (PIT) generates square waves
  * - Port 0x61 controls whether the speaker is enabled
  * - We calculate a "divisor" from the frequency we want
+ * 
+ * The speaker driver (sound/speaker.c) does all of that from the timer
+ * interrupt. Here we only queue tones: effects pre-empt the music, and the
+ * music carries on underneath once they end.
+ * 
+ * Music comes from song files on the disk, one per level (level_t.song),
+ * and is sequenced by sound/music.c, also from the timer interrupt. With an
+ * AdLib, update_music sends the FM chip the notes the interrupt queued.
  */
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
 #include "timer/timer.h"
+#include "sound/speaker.h"
+#include "sound/music.h"
+#include "sound/opl2.h"
 #include "breakout.h"
-#include "io/io.h"  // For inb/outb functions
 
 // External reference to game state (defined in breakout_main.c)
 extern game_state_t game;
+extern level_t levels[MAX_LEVELS];
+
+// Silences the speaker without touching game state (headless replays)
+static bool sound_muted = false;
+
+// Played for a level without a song of its own: the original 8-note
+// melody (C, D, E, F, G, F, E, D), a note every 2.5 seconds
+static const char default_song_text[] =
+    "tempo 24\n"
+    "rows 1\n"
+    "pattern 0\n"
+    "C5 D5 E5 F5 G5 F5 E5 D5\n";
+
+static music_song_t default_song;
+static music_song_t level_songs[MAX_LEVELS];
+
+/*
+ * sound_set_muted - Turn speaker output off or back on
+ */
+void sound_set_muted(bool muted)
+{
+    sound_muted = muted;
+}
+
+/*
+ * queue_tone - Hand a tone to the speaker driver (unless sound is off)
+ */
+static void queue_tone(int frequency, int duration_ms, speaker_priority_t priority)
+{
+    // Don't play if sound is disabled or frequency is 0
+    if (!game.sound_enabled || sound_muted || frequency == 0)
+    {
+        return;
+    }
+    
+    speaker_play((uint16_t)frequency, (uint16_t)duration_ms, priority);
+}
 
 /*
  * play_sound - Play a specific frequency through the PC speaker
  * 
  * This uses the PIT (Programmable Interval Timer) to generate a square wave
  * at the desired frequency. The PIT has a base frequency of 1193180 Hz, so
- * we divide that by our desired frequency to get the right divisor.
+ * the driver divides that by our desired frequency to get the right divisor.
+ * 
+ * The tone is only queued - the timer interrupt starts it within a
+ * millisecond and stops it after duration_ms, so this costs the game loop
+ * no port I/O. Sound effects play over the music.
  * 
  * Parameters:
  *   frequency - The frequency in Hz (e.g., 440 = A note)
- *   duration_ms - How long to play (not currently used, sound plays until stopped)
+ *   duration_ms - How long to play
  */
 void play_sound(int frequency, int duration_ms)
 {
-    // Don't play if sound is disabled or frequency is 0
-    if (!game.sound_enabled || frequency == 0)
-    {
-        return;
-    }
-    
-    // Calculate the PIT divisor for this frequency
-    // PIT base frequency is 1193180 Hz
-    uint32_t divisor = 1193180 / frequency;
-    
-    // Configure PIT channel 2 (the speaker channel)
-    // Command byte: 10110110 = channel 2, access mode lobyte/hibyte, square wave
-    outb(0x43, 0xB6);
-    
-    // Send the divisor (low byte then high byte)
-    outb(0x42, (uint8_t)(divisor & 0xFF));
-    outb(0x42, (uint8_t)((divisor >> 8) & 0xFF));
-    
-    // Enable the speaker
-    // Port 0x61 controls the speaker - we need to set bits 0 and 1
-    uint8_t tmp = insb(0x61);
-    outb(0x61, tmp | 0x03);  // Set bits 0 and 1 to enable
+    queue_tone(frequency, duration_ms, SPEAKER_EFFECT);
 }
 
 /*
  * stop_sound - Turn off the PC speaker
  * 
- * This disables the speaker by clearing the control bits in port 0x61.
+ * Silences effects and music, including anything still queued. The music
+ * stays off until update_music picks a song again.
  */
 void stop_sound()
 {
-    // Disable speaker by clearing bits 0 and 1 of port 0x61
-    uint8_t tmp = insb(0x61);
-    outb(0x61, tmp & 0xFC);  // Clear bits 0 and 1
+    music_play(0);
+    speaker_stop();
+    opl2_silence();
 }
 
 /*
- * update_music - Play background music
+ * load_music - Read every level's song from disk
  * 
- * This plays a simple 8-note melody that loops. It's called every frame
- * from the main game loop. We change notes every 30 frames (about 0.5 seconds).
+ * Songs are parsed here, once, into lists of notes the timer interrupt
+ * plays straight through. A level whose file is missing or broken gets the
+ * built-in melody instead.
  */
-void update_music()
+void load_music()
 {
-    // Don't play if sound is disabled
-    if (!game.sound_enabled)
+    static bool loaded = false;
+    
+    if (loaded)
     {
         return;
     }
     
-    // 8-note melody (C, D, E, F, G, F, E, D)
-    // These are frequencies in Hz
-    static const int melody[] = {
-        523,  // C5
-        587,  // D5
-        659,  // E5
-        698,  // F5
-        784,  // G5
-        698,  // F5
-        659,  // E5
-        587   // D5
-    };
-    static const int melody_length = 8;
+    music_parse(&default_song, default_song_text, sizeof(default_song_text) - 1);
     
-    // Increment music timer every frame
-    game.music_timer++;
+    for (int level = 0; level < MAX_LEVELS; level++)
+    {
+        if (!levels[level].song || music_load(&level_songs[level], levels[level].song) < 0)
+        {
+            level_songs[level].count = 0;
+        }
+    }
     
-    // Change note every 30 frames (about 0.5 seconds at 60 FPS)
-    if (game.music_timer >= 30)
+    loaded = true;
+}
+
+/*
+ * update_music - Play the current level's song
+ * 
+ * Called once per frame, but only tells the sequencer which song should be
+ * on and whether it is held - the notes themselves are started by the timer
+ * interrupt, at the song's exact tempo, whatever the frame rate. The AdLib's
+ * register writes are too slow for the interrupt, so they go out from here.
+ * 
+ * Parameters:
+ *   playing - false while paused or on a screen between levels
+ */
+void update_music(bool playing)
+{
+    const music_song_t* song = 0;
+    
+    if (game.sound_enabled && !sound_muted && game.level < MAX_LEVELS)
     {
-        game.music_timer = 0;  // Reset timer
-        
-        // Move to next note (wrap around to 0 after last note)
-        game.music_note = (game.music_note + 1) % melody_length;
-        
-        // Play the new note
-        play_sound(melody[game.music_note], 100);
+        song = level_songs[game.level].count ? &level_songs[game.level] : &default_song;
     }
-}
\ No newline at end of file
+    
+    music_play(song);
+    music_pause(!playing);
+    opl2_update();
+}
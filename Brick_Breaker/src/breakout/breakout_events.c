@@ -0,0 +1,264 @@
+/*
+ * breakout_events.c - Per-step gameplay event queue
+ *
+ * The collision loops used to play sounds, spawn explosions and power-ups
+ * and shake the screen right where a hit was found. Now they only push an
+ * event; events_drain() runs once at the end of breakout_step and turns the
+ * whole batch into score, power-up drops and effects.
+ *
+ * Effects are coalesced per step:
+ * - One sound: the most important one queued (see event_type_t)
+ * - At most EVENT_MAX_EXPLOSIONS explosions and EVENT_MAX_SPARKS sparks
+ * - One screen shake, however many bricks broke
+ *
+ * Laser hits score and drop power-ups like ball hits, but keep their own,
+ * quieter effects: an explosion or a brick shake, no sound or screen shake.
+ *
+ * Effects draw on their own random sequence (effect_random_range), and the
+ * particles and screen shake are left out of the replay checksum, so a
+ * headless replay can skip them and still end in the same state.
+ */
+
+#include "breakout.h"
+#include "breakout_events.h"
+#include "breakout_replay.h"
+#include "graphics/palette.h"
+
+extern game_state_t game;
+extern level_t levels[MAX_LEVELS];
+extern void spawn_particle(int x, int y, int dx, int dy, uint8_t color, int life);
+extern void spawn_explosion(int x, int y, uint8_t color);
+extern void spawn_powerup(int x, int y);
+extern int effect_random_range(int min, int max);
+
+// Effects kept per step (the rest are only counted)
+#define EVENT_MAX_EXPLOSIONS 16
+#define EVENT_MAX_SPARKS 4
+
+static game_event_t events[MAX_EVENTS];
+static int event_count = 0;
+static uint32_t dropped = 0;
+
+/* ============================================================================
+ * SOUNDS
+ * ============================================================================
+ */
+
+// Sound for each event type (0 Hz = silent)
+static const struct {
+    int frequency;
+    int duration_ms;
+} event_sounds[EVENT_TYPE_COUNT] = {
+    [EVENT_WALL_HIT]        = { 400, 30 },
+    [EVENT_PADDLE_HIT]      = { 600, 30 },
+    [EVENT_BRICK_DAMAGED]   = { 300, 30 },
+    [EVENT_BRICK_DESTROYED] = { 200, 50 },   // Pitch varied by up to 100 Hz
+    [EVENT_LIFE_LOST]       = { 0, 0 },      // The red flash says it all
+    [EVENT_POWERUP_CAUGHT]  = { 0, 100 },    // Pitch from powerup_sounds
+};
+
+// Power-up catch pitch: high for good ones, low for bad ones
+static const int powerup_sounds[POWERUP_COUNT] = {
+    [POWERUP_MULTIBALL]     = 800,
+    [POWERUP_EXPAND_PADDLE] = 600,
+    [POWERUP_SHRINK_PADDLE] = 400,
+    [POWERUP_LASER]         = 1000,
+    [POWERUP_SLOW_BALL]     = 300,
+    [POWERUP_EXTRA_LIFE]    = 1200,
+    [POWERUP_FAST_BALL]     = 900,
+};
+
+/*
+ * event_frequency - Pitch of an event's sound (0 = silent)
+ */
+static int event_frequency(const game_event_t* event)
+{
+    switch (event->type)
+    {
+        case EVENT_BRICK_DESTROYED:
+            return event_sounds[event->type].frequency + effect_random_range(0, 100);
+
+        case EVENT_POWERUP_CAUGHT:
+            return (event->powerup < POWERUP_COUNT) ? powerup_sounds[event->powerup] : 0;
+
+        default:
+            return event_sounds[event->type].frequency;
+    }
+}
+
+/* ============================================================================
+ * HANDLING
+ * ============================================================================
+ */
+
+/*
+ * apply_event - The part of an event that changes the simulation
+ *
+ * Runs for every event, headless or not, and even if it didn't fit in the
+ * queue, so the score and power-up drops never depend on either.
+ */
+static void apply_event(const game_event_t* event)
+{
+    switch (event->type)
+    {
+        case EVENT_BRICK_DESTROYED:
+            game.players[game.current_player].score += 10;
+            spawn_powerup(BRICK_X(event->col), BRICK_Y(event->row));
+            break;
+
+        case EVENT_BRICK_DAMAGED:
+            game.bricks[event->row][event->col].shake_timer = 5;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*
+ * queue - Add an event, or apply it straight away if the queue is full
+ */
+static void queue(const game_event_t* event)
+{
+    if (event_count == MAX_EVENTS)
+    {
+        apply_event(event);
+        dropped++;
+        return;
+    }
+
+    events[event_count++] = *event;
+}
+
+void events_push(event_type_t type, int x, int y)
+{
+    game_event_t event = { .type = type, .x = (int16_t)x, .y = (int16_t)y };
+    queue(&event);
+}
+
+static void push_brick(event_type_t type, int row, int col, bool laser)
+{
+    game_event_t event = {
+        .type = type,
+        .row = (uint8_t)row,
+        .col = (uint8_t)col,
+        .laser = laser,
+        .x = (int16_t)(BRICK_X(col) + BRICK_WIDTH / 2),
+        .y = (int16_t)(BRICK_Y(row) + BRICK_HEIGHT / 2),
+    };
+    queue(&event);
+}
+
+void events_push_brick(event_type_t type, int row, int col)
+{
+    push_brick(type, row, col, false);
+}
+
+void events_push_laser_hit(event_type_t type, int row, int col)
+{
+    push_brick(type, row, col, true);
+}
+
+void events_push_powerup(const powerup_t* powerup)
+{
+    game_event_t event = {
+        .type = EVENT_POWERUP_CAUGHT,
+        .powerup = (uint8_t)powerup->type,
+        .color = powerup->color,
+        .x = (int16_t)powerup->x,
+        .y = (int16_t)powerup->y,
+    };
+    queue(&event);
+}
+
+/*
+ * events_drain - Handle this step's events in one go
+ */
+void events_drain()
+{
+    bool effects = !replay_headless();
+    const game_event_t* loudest = 0;
+    int explosions = 0;
+    int sparks = 0;
+    bool shake = false;
+
+    for (int i = 0; i < event_count; i++)
+    {
+        const game_event_t* event = &events[i];
+
+        apply_event(event);
+        if (!effects)
+        {
+            continue;
+        }
+
+        // Later types win, and the last of a type wins (as it used to,
+        // when each sound simply cut off the one before)
+        if (event_sounds[event->type].duration_ms > 0 && !event->laser &&
+            (!loudest || event->type >= loudest->type))
+        {
+            loudest = event;
+        }
+
+        switch (event->type)
+        {
+            case EVENT_PADDLE_HIT:
+                if (sparks++ < EVENT_MAX_SPARKS)
+                {
+                    spawn_particle(event->x, event->y, 0, -2, 15, 10);
+                    spawn_particle(event->x, event->y, 1, -2, 14, 10);
+                    spawn_particle(event->x, event->y, -1, -2, 14, 10);
+                }
+                break;
+
+            case EVENT_BRICK_DESTROYED:
+                if (explosions++ < EVENT_MAX_EXPLOSIONS)
+                {
+                    spawn_explosion(event->x, event->y, levels[game.level].colors[event->row]);
+                }
+                if (!event->laser)
+                {
+                    shake = true;
+                }
+                break;
+
+            case EVENT_POWERUP_CAUGHT:
+                spawn_explosion(event->x, event->y, event->color);
+                break;
+
+            case EVENT_LIFE_LOST:
+                // Red flash done in the palette - no pixels are repainted
+                palette_flash(255, 0, 0, 300);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (shake)
+    {
+        game.screen_shake_timer = 3;
+    }
+
+    if (loudest)
+    {
+        int frequency = event_frequency(loudest);
+        if (frequency > 0)
+        {
+            play_sound(frequency, event_sounds[loudest->type].duration_ms);
+        }
+    }
+
+    event_count = 0;
+}
+
+void events_clear()
+{
+    event_count = 0;
+}
+
+uint32_t events_dropped()
+{
+    return dropped;
+}
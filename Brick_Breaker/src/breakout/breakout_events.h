@@ -0,0 +1,56 @@
+#ifndef BREAKOUT_EVENTS_H
+#define BREAKOUT_EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "breakout.h"
+
+/*
+ * Gameplay events. The simulation (balls, lasers, power-ups) only changes
+ * the game state and notes what happened here; scoring, power-up drops,
+ * sound and visual effects are all handled by events_drain() in one batch
+ * at the end of the step.
+ *
+ * Draining coalesces: the speaker plays one sound per step however many
+ * bricks broke, and explosions, sparks and screen shake are capped. In a
+ * headless replay only the parts that change the simulation are run.
+ */
+
+// Most events queued in one step. Events past this still count towards
+// the score and power-up drops (see events_push), only their effects are lost.
+#define MAX_EVENTS 256
+
+// What happened. The later a type comes, the more its sound matters when
+// several play in one step.
+typedef enum {
+    EVENT_WALL_HIT = 0,
+    EVENT_PADDLE_HIT,      // x, y: ball position
+    EVENT_BRICK_DAMAGED,   // row, col
+    EVENT_BRICK_DESTROYED, // row, col
+    EVENT_LIFE_LOST,
+    EVENT_POWERUP_CAUGHT,  // x, y: power-up position, type and color
+    EVENT_TYPE_COUNT
+} event_type_t;
+
+typedef struct {
+    uint8_t type;          // event_type_t
+    uint8_t row, col;      // Brick events: which brick
+    uint8_t powerup;       // EVENT_POWERUP_CAUGHT: powerup_type_t
+    uint8_t color;         // EVENT_POWERUP_CAUGHT: power-up color
+    uint8_t laser;         // Brick events: hit by a laser (no sound or shake)
+    int16_t x, y;          // Where it happened
+} game_event_t;
+
+// Queueing (from the simulation)
+void events_push(event_type_t type, int x, int y);
+void events_push_brick(event_type_t type, int row, int col);
+void events_push_laser_hit(event_type_t type, int row, int col);
+void events_push_powerup(const powerup_t* powerup);
+
+// Handle everything queued this step, then empty the queue
+void events_drain();
+void events_clear();   // Drop anything queued (new game)
+
+uint32_t events_dropped();   // Events that didn't fit in the queue so far
+
+#endif // BREAKOUT_EVENTS_H
@@ -14,12 +14,17 @@
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
+#include "graphics/palette.h"
 #include "timer/timer.h"
 #include "breakout.h"
+#include "breakout_profile.h"
 
 // External references
 extern game_state_t game;
 extern level_t levels[MAX_LEVELS];
+extern uint32_t brick_live_bits(int row, int word, int col_first, int col_last);
+extern bool brick_cells_in_rect(int x, int y, int width, int height,
+                                int* row_first, int* row_last, int* col_first, int* col_last);
 
 /* ============================================================================
  * HELPER DRAWING FUNCTIONS
@@ -31,28 +36,11 @@ extern level_t levels[MAX_LEVELS];
  * 
  * This is our basic drawing primitive. Everything builds on this!
  * Screen shake offset is automatically applied for cool effects.
+ * The VGA span filler clips it once and fills whole rows at a time.
  */
 void draw_rect(int x, int y, int width, int height, uint8_t color)
 {
-    // Apply screen shake offset
-    x += game.screen_shake_x;
-    y += game.screen_shake_y;
-    
-    // Draw each pixel in the rectangle
-    for (int dy = 0; dy < height; dy++)
-    {
-        for (int dx = 0; dx < width; dx++)
-        {
-            int px = x + dx;
-            int py = y + dy;
-            
-            // Bounds checking (don't draw off-screen)
-            if (px >= 0 && px < VGA_WIDTH && py >= 0 && py < VGA_HEIGHT)
-            {
-                vga_set_pixel(px, py, color);
-            }
-        }
-    }
+    vga_fill_rect(x + game.screen_shake_x, y + game.screen_shake_y, width, height, color);
 }
 
 /*
@@ -60,139 +48,258 @@ void draw_rect(int x, int y, int width, int height, uint8_t color)
  */
 void draw_pixel(int x, int y, uint8_t color)
 {
-    x += game.screen_shake_x;
-    y += game.screen_shake_y;
-    
-    if (x >= 0 && x < VGA_WIDTH && y >= 0 && y < VGA_HEIGHT)
-    {
-        vga_set_pixel(x, y, color);
-    }
+    vga_set_pixel(x + game.screen_shake_x, y + game.screen_shake_y, color);
 }
 
-/* ============================================================================
- * BRICK RENDERING
- * ============================================================================
+/*
+ * draw_hline / draw_vline - Draw a 1-pixel line with screen shake
  */
+void draw_hline(int x, int y, int width, uint8_t color)
+{
+    vga_draw_hline(x + game.screen_shake_x, y + game.screen_shake_y, width, color);
+}
+
+void draw_vline(int x, int y, int height, uint8_t color)
+{
+    vga_draw_vline(x + game.screen_shake_x, y + game.screen_shake_y, height, color);
+}
 
 /*
- * draw_bricks - Draw all bricks with 3D gradient effect
- * 
+ * draw_border - Draw a hollow rectangle (1-pixel border) with screen shake
+ */
+void draw_border(int x, int y, int width, int height, uint8_t color)
+{
+    vga_draw_border(x + game.screen_shake_x, y + game.screen_shake_y, width, height, color);
+}
+
+/* ============================================================================
+ * BRICK RENDERING (SPRITE CACHE)
+ * ============================================================================
  * Each brick is drawn in 3 horizontal layers:
  * - Top layer: Lighter shade (highlight)
  * - Middle layer: Base color
  * - Bottom layer: Darker shade (shadow)
+ * plus a black border and white health dots. Damaged bricks are darker.
  * 
- * This creates a nice 3D look! Damaged bricks are darker.
+ * A level only has a handful of different looks (row color x health 1-3),
+ * so we bake each one into a small sprite when the level is set up and
+ * draw bricks by copying sprite rows.
  */
-void draw_bricks()
+
+// At most one sprite per (row, health) pair
+#define BRICK_SPRITE_MAX (BRICK_ROWS * 3)
+
+static uint8_t brick_sprites[BRICK_SPRITE_MAX][BRICK_HEIGHT][BRICK_WIDTH];
+static int brick_sprite_count = 0;
+static int brick_sprite_level = -1;
+
+// Which sprite to use for [row][health - 1]
+static uint8_t brick_sprite_index[BRICK_ROWS][3];
+
+// Bricks change rarely, so they live in their own full-screen layer that
+// is only repainted where a brick was hit or is shaking. Each frame just
+// copies it under the moving objects.
+static uint8_t static_layer[VGA_WIDTH * VGA_HEIGHT] __attribute__((aligned(16)));
+static bool static_layer_stale = true;
+static bool static_cell_dirty[BRICK_ROWS][BRICK_COLS];
+
+// Colors each sprite was baked with (to share identical variants)
+static uint8_t brick_sprite_color[BRICK_SPRITE_MAX];
+static uint8_t brick_sprite_health[BRICK_SPRITE_MAX];
+
+/*
+ * bake_brick_sprite - Render one brick variant into a sprite
+ */
+static void bake_brick_sprite(uint8_t sprite[BRICK_HEIGHT][BRICK_WIDTH], uint8_t base_color, int health)
+{
+    // Calculate gradient colors for 3D effect
+    uint8_t light_color = base_color;
+    uint8_t dark_color = base_color;
+    
+    // Map base colors to lighter variants
+    if (base_color == 4) light_color = 12;  // Red -> Light red
+    if (base_color == 2) light_color = 10;  // Green -> Light green
+    if (base_color == 1) light_color = 9;   // Blue -> Light blue
+    
+    // Map to darker variants
+    if (base_color > 8)
+    {
+        dark_color = base_color - 4;
+    }
+    
+    for (int y = 0; y < BRICK_HEIGHT; y++)
+    {
+        // 3 horizontal layers for gradient: top 3, middle 4, bottom 3
+        uint8_t color = (y < 3) ? light_color : (y < 7) ? base_color : dark_color;
+        
+        for (int x = 0; x < BRICK_WIDTH; x++)
+        {
+            // Black border for definition
+            bool border = (x == 0 || x == BRICK_WIDTH - 1 || y == 0 || y == BRICK_HEIGHT - 1);
+            sprite[y][x] = border ? 0 : color;
+        }
+    }
+    
+    // Health indicator dots (2x2 white, shows hits remaining)
+    for (int h = 0; h < health && h < 3; h++)
+    {
+        int dot_x = 3 + h * 4;
+        sprite[2][dot_x] = 15;
+        sprite[2][dot_x + 1] = 15;
+        sprite[3][dot_x] = 15;
+        sprite[3][dot_x + 1] = 15;
+    }
+}
+
+/*
+ * build_brick_sprites - Bake every brick variant for the current level
+ * 
+ * Called from init_bricks(). Variants that look the same (for example all
+ * 1-hit bricks, which are drawn dark gray) share one sprite.
+ */
+void build_brick_sprites()
 {
+    brick_sprite_count = 0;
+    
     for (int row = 0; row < BRICK_ROWS; row++)
     {
-        for (int col = 0; col < BRICK_COLS; col++)
+        for (int health = 1; health <= 3; health++)
         {
-            // Skip destroyed bricks
-            if (game.bricks[row][col].health == 0)
-            {
-                continue;
-            }
-            
-            // Calculate position (include shake offset if brick is shaking)
-            int brick_x = col * (BRICK_WIDTH + 2) + 5 + game.bricks[row][col].shake_x;
-            int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_START_Y + game.bricks[row][col].shake_y;
-            
-            // Get base color from level
-            uint8_t base_color = levels[game.level].colors[row];
-            
             // Damaged bricks look darker
-            if (game.bricks[row][col].health == 1)
+            uint8_t base_color = levels[game.level].colors[row];
+            if (health == 1)
             {
                 base_color = 8;  // Dark gray
             }
             
-            // Calculate gradient colors for 3D effect
-            uint8_t light_color = base_color;
-            uint8_t dark_color = base_color;
-            
-            // Map base colors to lighter variants
-            if (base_color == 4) light_color = 12;  // Red -> Light red
-            if (base_color == 2) light_color = 10;  // Green -> Light green
-            if (base_color == 1) light_color = 9;   // Blue -> Light blue
-            
-            // Map to darker variants
-            if (base_color > 8)
+            // Reuse an identical sprite if we already baked one
+            int index = 0;
+            while (index < brick_sprite_count &&
+                   (brick_sprite_color[index] != base_color || brick_sprite_health[index] != health))
             {
-                dark_color = base_color - 4;
+                index++;
             }
             
-            // Draw 3 horizontal layers for gradient
-            draw_rect(brick_x, brick_y, BRICK_WIDTH, 3, light_color);      // Top (light)
-            draw_rect(brick_x, brick_y + 3, BRICK_WIDTH, 4, base_color);   // Middle
-            draw_rect(brick_x, brick_y + 7, BRICK_WIDTH, 3, dark_color);   // Bottom (dark)
-            
-            // Draw black border for definition
-            for (int i = 0; i < BRICK_WIDTH; i++)
-            {
-                draw_pixel(brick_x + i, brick_y, 0);
-                draw_pixel(brick_x + i, brick_y + BRICK_HEIGHT - 1, 0);
-            }
-            for (int i = 0; i < BRICK_HEIGHT; i++)
+            if (index == brick_sprite_count)
             {
-                draw_pixel(brick_x, brick_y + i, 0);
-                draw_pixel(brick_x + BRICK_WIDTH - 1, brick_y + i, 0);
+                bake_brick_sprite(brick_sprites[index], base_color, health);
+                brick_sprite_color[index] = base_color;
+                brick_sprite_health[index] = health;
+                brick_sprite_count++;
             }
             
-            // Draw health indicator dots (shows hits remaining)
-            for (int h = 0; h < game.bricks[row][col].health && h < 3; h++)
+            brick_sprite_index[row][health - 1] = index;
+        }
+    }
+    
+    brick_sprite_level = game.level;
+    
+    // New level, new bricks: the static layer has to be rebuilt
+    static_layer_stale = true;
+}
+
+/*
+ * get_brick_sprite_count - How many brick variants are resident
+ */
+int get_brick_sprite_count()
+{
+    return brick_sprite_count;
+}
+
+/*
+ * draw_brick_range - Draw the standing bricks in a block of grid cells
+ * 
+ * Walks the occupancy bits, so destroyed bricks and empty rows cost
+ * nothing.
+ */
+static void draw_brick_range(int row_first, int row_last, int col_first, int col_last)
+{
+    for (int row = row_first; row <= row_last; row++)
+    {
+        for (int word = col_first / BRICK_WORD_BITS; word <= col_last / BRICK_WORD_BITS; word++)
+        {
+            uint32_t bits = brick_live_bits(row, word, col_first, col_last);
+            
+            while (bits != 0)
             {
-                int dot_x = brick_x + 3 + h * 4;
-                int dot_y = brick_y + 2;
+                int col = word * BRICK_WORD_BITS + BRICK_BIT_SCAN(bits);
+                bits &= bits - 1;
+                
+                int health = game.bricks[row][col].health;
+                if (health > 3)
+                {
+                    health = 3;
+                }
                 
-                // Draw 2x2 pixel dot (white)
-                draw_pixel(dot_x, dot_y, 15);
-                draw_pixel(dot_x + 1, dot_y, 15);
-                draw_pixel(dot_x, dot_y + 1, 15);
-                draw_pixel(dot_x + 1, dot_y + 1, 15);
+                // Calculate position (include shake offset if brick is shaking)
+                int brick_x = BRICK_X(col) + game.bricks[row][col].shake_x;
+                int brick_y = BRICK_Y(row) + game.bricks[row][col].shake_y;
+                
+                const uint8_t* sprite = &brick_sprites[brick_sprite_index[row][health - 1]][0][0];
+                vga_blit(brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT, sprite, BRICK_WIDTH);
             }
         }
     }
 }
 
+/*
+ * draw_bricks - Draw all bricks from the sprite cache
+ * 
+ * Bricks are drawn without screen shake: they go into the static layer,
+ * which gets shaken as a whole when it is composited (see render_frame).
+ */
+void draw_bricks()
+{
+    draw_brick_range(0, BRICK_ROWS - 1, 0, BRICK_COLS - 1);
+}
+
 /* ============================================================================
  * BALL RENDERING
  * ============================================================================
  */
 
+/*
+ * ball_draw_position - Where a ball is drawn this frame
+ * 
+ * Frames don't line up with simulation steps, so the ball is drawn
+ * between its last two positions, game.sim_blend of the way along.
+ */
+static void ball_draw_position(const ball_t* ball, int* x, int* y)
+{
+    *x = FIXED_TO_INT(ball->prev_x + (ball->x - ball->prev_x) * game.sim_blend / SIM_BLEND_FULL);
+    *y = FIXED_TO_INT(ball->prev_y + (ball->y - ball->prev_y) * game.sim_blend / SIM_BLEND_FULL);
+}
+
 /*
  * draw_balls - Draw all active balls with motion trails
  * 
  * Each ball has a fading trail showing where it's been.
- * The trail is stored as a circular buffer of the last 10 positions.
+ * The trail is stored as a circular buffer of the last BALL_TRAIL_LENGTH
+ * positions (see game.ball_trails).
  */
 void draw_balls()
 {
-    for (int i = 0; i < MAX_BALLS; i++)
+    const ball_t* ball;
+    POOL_FOR_EACH(&game.balls, ball)
     {
-        if (!game.balls[i].active)
-        {
-            continue;
-        }
+        const uint16_t* trail = game.ball_trails[ball - game.balls.items];
         
-        // Draw trail (oldest positions are darker)
-        for (int t = 0; t < 10; t++)
+        // Draw trail, oldest first (older = darker, on the VGA gray ramp)
+        for (int age = BALL_TRAIL_LENGTH - 1; age >= 0; age--)
         {
-            // Calculate fade color (older = darker)
-            int alpha = t * 2;
-            if (alpha > 8) alpha = 8;
-            uint8_t trail_color = 8 + alpha;  // Dark gray to light gray gradient
+            uint16_t point = trail[(game.trail_head - age) & (BALL_TRAIL_LENGTH - 1)];
+            uint8_t trail_color = 28 - age;
             
-            draw_pixel(game.balls[i].trail_x[t], game.balls[i].trail_y[t], trail_color);
+            draw_pixel(point % VGA_WIDTH, point / VGA_WIDTH, trail_color);
         }
         
-        // Draw main ball (white with yellow highlight)
-        draw_rect(game.balls[i].x, game.balls[i].y, BALL_SIZE, BALL_SIZE, 15);
+        // Draw main ball (white with yellow highlight) at its whole-pixel position
+        int ball_x, ball_y;
+        ball_draw_position(ball, &ball_x, &ball_y);
+        draw_rect(ball_x, ball_y, BALL_SIZE, BALL_SIZE, 15);
         
         // Add highlight pixel for 3D look
-        draw_pixel(game.balls[i].x + 1, game.balls[i].y + 1, 14);
+        draw_pixel(ball_x + 1, ball_y + 1, 14);
     }
 }
 
@@ -238,34 +345,20 @@ void draw_paddle()
  */
 void draw_powerups()
 {
-    for (int i = 0; i < MAX_POWERUPS; i++)
+    const powerup_t* powerup;
+    POOL_FOR_EACH(&game.powerups, powerup)
     {
-        if (!game.powerups[i].active)
-        {
-            continue;
-        }
-        
         // Draw power-up box
-        draw_rect(game.powerups[i].x, game.powerups[i].y, 
-                 POWERUP_SIZE, POWERUP_SIZE, game.powerups[i].color);
+        draw_rect(powerup->x, powerup->y, POWERUP_SIZE, POWERUP_SIZE, powerup->color);
         
-        // Draw white border
-        for (int j = 0; j < POWERUP_SIZE; j++)
-        {
-            draw_pixel(game.powerups[i].x + j, game.powerups[i].y, 15);
-            draw_pixel(game.powerups[i].x + j, game.powerups[i].y + POWERUP_SIZE - 1, 15);
-            draw_pixel(game.powerups[i].x, game.powerups[i].y + j, 15);
-            draw_pixel(game.powerups[i].x + POWERUP_SIZE - 1, game.powerups[i].y + j, 15);
-        }
+        // Draw pulsing border (palette-cycled, so it animates without repainting)
+        draw_border(powerup->x, powerup->y, POWERUP_SIZE, POWERUP_SIZE, PALETTE_PULSE_FIRST);
         
         // Draw simple icon (black cross in center)
-        int cx = game.powerups[i].x + POWERUP_SIZE / 2;
-        int cy = game.powerups[i].y + POWERUP_SIZE / 2;
-        draw_pixel(cx, cy, 0);
-        draw_pixel(cx - 1, cy, 0);
-        draw_pixel(cx + 1, cy, 0);
-        draw_pixel(cx, cy - 1, 0);
-        draw_pixel(cx, cy + 1, 0);
+        int cx = powerup->x + POWERUP_SIZE / 2;
+        int cy = powerup->y + POWERUP_SIZE / 2;
+        draw_hline(cx - 1, cy, 3, 0);
+        draw_vline(cx, cy - 1, 3, 0);
     }
 }
 
@@ -283,16 +376,12 @@ void draw_lasers()
 {
     player_t* player = &game.players[game.current_player];
     
-    for (int i = 0; i < MAX_LASERS; i++)
+    const laser_t* laser;
+    POOL_FOR_EACH(&player->lasers, laser)
     {
-        if (!player->lasers[i].active)
-        {
-            continue;
-        }
-        
         // Draw laser beam (2 pixels wide, 5 pixels tall)
-        draw_rect(player->lasers[i].x, player->lasers[i].y, 2, 5, 10);  // Light green
-        draw_rect(player->lasers[i].x, player->lasers[i].y, 1, 5, 15);  // White core
+        draw_rect(laser->x, laser->y, 2, 5, 10);  // Light green
+        draw_rect(laser->x, laser->y, 1, 5, 15);  // White core
     }
 }
 
@@ -308,22 +397,360 @@ void draw_lasers()
  */
 void draw_particles()
 {
-    for (int i = 0; i < MAX_PARTICLES; i++)
+    const particle_pool_t* pool = &game.particles;
+    
+    for (int i = 0; i < pool->count; i++)
     {
-        if (!game.particles[i].active)
-        {
-            continue;
-        }
-        
         // Fade color when particle is dying
-        uint8_t color = game.particles[i].color;
-        if (game.particles[i].life < 5)
+        uint8_t color = pool->color[i];
+        if (pool->life[i] < 5)
         {
             color = 8;  // Fade to dark gray
         }
         
         // Draw particle (2 pixels for visibility)
-        draw_pixel(game.particles[i].x, game.particles[i].y, color);
-        draw_pixel(game.particles[i].x + 1, game.particles[i].y, color);
+        draw_hline(pool->x[i], pool->y[i], 2, color);
     }
-}
\ No newline at end of file
+}
+
+/* ============================================================================
+ * DIRTY-RECTANGLE FRAME RENDERING
+ * ============================================================================
+ * Most of the screen doesn't change between frames, so instead of clearing
+ * and repainting all 64,000 pixels we only redraw the regions that changed:
+ * - Moving objects report where they were last frame and where they are now
+ * - Brick damage/shake reports the brick's cell (see mark_brick_dirty)
+ * - The HUD is reported when score, lives, level or player change
+ * Each dirty region is then refilled from the static brick layer and the
+ * moving objects are redrawn on top, with drawing clipped to the region.
+ */
+
+extern void draw_hud();
+
+// One slot per dynamic object: balls, paddle, power-ups, lasers, particles
+#define SLOT_BALLS      0
+#define SLOT_PADDLE     (SLOT_BALLS + MAX_BALLS)
+#define SLOT_POWERUPS   (SLOT_PADDLE + 1)
+#define SLOT_LASERS     (SLOT_POWERUPS + MAX_POWERUPS)
+#define SLOT_PARTICLES  (SLOT_LASERS + MAX_LASERS)
+#define DIRTY_SLOTS     (SLOT_PARTICLES + MAX_PARTICLES)
+
+// More balls than this redraw the whole screen instead of dirty regions
+#define BALL_TRACK_MAX 16
+
+// Where each object was drawn last frame (width 0 = nothing drawn)
+static vga_rect_t last_drawn[DIRTY_SLOTS];
+static int particle_slots = 0;    // Particle slots drawn last frame
+
+// HUD values shown last frame (-1 forces a redraw)
+static int hud_score = -1;
+static int hud_lives = -1;
+static int hud_level = -1;
+static int hud_player = -1;
+
+// Screen shake offset used last frame
+static int last_shake_x = 0;
+static int last_shake_y = 0;
+
+/*
+ * brick_cell - Screen area a brick can cover, padded by the maximum shake
+ */
+static vga_rect_t brick_cell(int row, int col)
+{
+    vga_rect_t cell;
+    
+    cell.x = BRICK_X(col) - 2;
+    cell.y = BRICK_Y(row) - 1;
+    cell.width = BRICK_WIDTH + 4;
+    cell.height = BRICK_HEIGHT + 2;
+    
+    return cell;
+}
+
+/*
+ * mark_brick_dirty - Report that a brick's cell needs repainting
+ * 
+ * Called whenever a brick's health or shake changes. The cell is padded
+ * by the maximum shake offset so the old shaken position is erased too.
+ * The cell is repainted in the static layer and then on screen.
+ */
+void mark_brick_dirty(int row, int col)
+{
+    vga_rect_t cell = brick_cell(row, col);
+    
+    static_cell_dirty[row][col] = true;
+    vga_mark_dirty(cell.x, cell.y, cell.width, cell.height);
+}
+
+/*
+ * update_static_layer - Bring the brick layer up to date
+ * 
+ * A stale layer (new level) is rebuilt completely; otherwise only the
+ * cells reported through mark_brick_dirty() are cleared and redrawn.
+ * Neighbouring bricks are redrawn too, clipped to the cell.
+ */
+static void update_static_layer()
+{
+    vga_set_target(static_layer);
+    
+    if (static_layer_stale)
+    {
+        vga_clear(0);
+        draw_bricks();
+        
+        for (int row = 0; row < BRICK_ROWS; row++)
+        {
+            for (int col = 0; col < BRICK_COLS; col++)
+            {
+                static_cell_dirty[row][col] = false;
+            }
+        }
+        
+        static_layer_stale = false;
+        vga_set_target(0);
+        vga_mark_all_dirty();
+        return;
+    }
+    
+    for (int row = 0; row < BRICK_ROWS; row++)
+    {
+        for (int col = 0; col < BRICK_COLS; col++)
+        {
+            if (!static_cell_dirty[row][col])
+            {
+                continue;
+            }
+            
+            vga_rect_t cell = brick_cell(row, col);
+            int row_first, row_last, col_first, col_last;
+            
+            vga_set_clip(&cell);
+            vga_fill_rect(cell.x, cell.y, cell.width, cell.height, 0);
+            
+            // Only neighbours that can shake into the cell need redrawing
+            if (brick_cells_in_rect(cell.x - 2, cell.y - 1, cell.width + 4, cell.height + 2,
+                                    &row_first, &row_last, &col_first, &col_last))
+            {
+                draw_brick_range(row_first, row_last, col_first, col_last);
+            }
+            
+            static_cell_dirty[row][col] = false;
+        }
+    }
+    
+    vga_reset_clip();
+    vga_set_target(0);
+}
+
+/*
+ * invalidate_screen - Force the next frame to repaint everything
+ * 
+ * Call this after a full-screen UI (level start, countdown...) has
+ * replaced the game picture in the back buffer.
+ */
+void invalidate_screen()
+{
+    vga_mark_all_dirty();
+    
+    // Particle slots past the ones drawn last frame are already empty
+    for (int i = 0; i < SLOT_PARTICLES + particle_slots; i++)
+    {
+        last_drawn[i].width = 0;
+    }
+    particle_slots = 0;
+    
+    hud_score = -1;
+}
+
+/*
+ * track_object - Report an object's old and new screen area
+ */
+static void track_object(int slot, bool active, int x, int y, int width, int height)
+{
+    vga_rect_t* last = &last_drawn[slot];
+    
+    if (last->width > 0)
+    {
+        vga_mark_dirty(last->x, last->y, last->width, last->height);
+    }
+    
+    if (!active)
+    {
+        last->width = 0;
+        return;
+    }
+    
+    last->x = x + game.screen_shake_x;
+    last->y = y + game.screen_shake_y;
+    last->width = width;
+    last->height = height;
+    vga_mark_dirty(last->x, last->y, width, height);
+}
+
+/*
+ * mark_dynamic_objects - Report everything that moves this frame
+ */
+static void mark_dynamic_objects()
+{
+    player_t* player = &game.players[game.current_player];
+    
+    // Past a few dozen balls the regions all merge into one anyway, and
+    // every region redraws every ball, so just repaint the whole screen
+    // (tracking below still records where things were drawn)
+    if (game.balls.count > BALL_TRACK_MAX)
+    {
+        vga_mark_all_dirty();
+    }
+    
+    // Balls - the box covers the ball and its whole motion trail
+    for (int i = 0; i < MAX_BALLS; i++)
+    {
+        ball_t* ball = &game.balls.items[i];
+        int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+        
+        if (ball->active)
+        {
+            ball_draw_position(ball, &x1, &y1);
+            x2 = x1 + BALL_SIZE;
+            y2 = y1 + BALL_SIZE;
+            
+            for (int t = 0; t < BALL_TRAIL_LENGTH; t++)
+            {
+                int trail_x = game.ball_trails[i][t] % VGA_WIDTH;
+                int trail_y = game.ball_trails[i][t] / VGA_WIDTH;
+                
+                if (trail_x < x1) x1 = trail_x;
+                if (trail_y < y1) y1 = trail_y;
+                if (trail_x + 1 > x2) x2 = trail_x + 1;
+                if (trail_y + 1 > y2) y2 = trail_y + 1;
+            }
+        }
+        
+        track_object(SLOT_BALLS + i, ball->active, x1, y1, x2 - x1, y2 - y1);
+    }
+    
+    // Paddle (plus laser indicators above it)
+    track_object(SLOT_PADDLE, true, player->paddle_x, PADDLE_Y - 3,
+                 player->paddle_width, PADDLE_HEIGHT + 3);
+    
+    for (int i = 0; i < MAX_POWERUPS; i++)
+    {
+        const powerup_t* powerup = &game.powerups.items[i];
+        track_object(SLOT_POWERUPS + i, powerup->active,
+                     powerup->x, powerup->y, POWERUP_SIZE, POWERUP_SIZE);
+    }
+    
+    for (int i = 0; i < MAX_LASERS; i++)
+    {
+        const laser_t* laser = &player->lasers.items[i];
+        track_object(SLOT_LASERS + i, laser->active, laser->x, laser->y, 2, 5);
+    }
+    
+    // Particles get moved around the pool as others die, so a slot is just
+    // "whatever was at this index". Every old spot is still cleared and
+    // every new one drawn; only slots in use now or last frame are visited.
+    const particle_pool_t* pool = &game.particles;
+    int slots = pool->count > particle_slots ? pool->count : particle_slots;
+    for (int i = 0; i < slots; i++)
+    {
+        track_object(SLOT_PARTICLES + i, i < pool->count, pool->x[i], pool->y[i], 2, 1);
+    }
+    particle_slots = pool->count;
+}
+
+/*
+ * mark_hud - Report the HUD if anything it shows has changed
+ */
+static void mark_hud()
+{
+    player_t* player = &game.players[game.current_player];
+    
+    if (player->score == hud_score && player->lives == hud_lives &&
+        game.level == hud_level && game.current_player == hud_player)
+    {
+        return;
+    }
+    
+    hud_score = player->score;
+    hud_lives = player->lives;
+    hud_level = game.level;
+    hud_player = game.current_player;
+    
+    vga_mark_dirty(0, 0, VGA_WIDTH, 20);                  // Player, score, level
+    vga_mark_dirty(0, VGA_HEIGHT - 12, 80, 12);           // Lives
+}
+
+#ifdef BREAKOUT_PROFILE
+/*
+ * mark_profile_overlay - The overlay changes every frame while it's shown
+ */
+static void mark_profile_overlay()
+{
+    if (profile_overlay_visible() || profile_overlay_changed())
+    {
+        int x, y, width, height;
+        profile_overlay_rect(&x, &y, &width, &height);
+        vga_mark_dirty(x, y, width, height);
+    }
+}
+#endif
+
+/*
+ * render_frame - Redraw the dirty parts of the game screen
+ * 
+ * Draws into the back buffer only; the caller presents it with vga_present().
+ */
+void render_frame()
+{
+    // Screen shake moves everything, so start and end of a shake repaint it all
+    if (game.screen_shake_x != last_shake_x || game.screen_shake_y != last_shake_y ||
+        game.screen_shake_x != 0 || game.screen_shake_y != 0)
+    {
+        vga_mark_all_dirty();
+    }
+    last_shake_x = game.screen_shake_x;
+    last_shake_y = game.screen_shake_y;
+    
+    // Level changed without init_bricks()? Rebake to be safe (not once the
+    // last level is cleared: game.level is then past the end of levels[])
+    if (brick_sprite_level != game.level && game.level < MAX_LEVELS)
+    {
+        build_brick_sprites();
+    }
+    
+    PROFILE(PROFILE_DRAW_BRICKS, update_static_layer());
+    mark_dynamic_objects();
+    mark_hud();
+#ifdef BREAKOUT_PROFILE
+    mark_profile_overlay();
+#endif
+    
+    // Copy the brick layer into each dirty region, then draw the moving
+    // objects and HUD on top with drawing clipped to it
+    const vga_rect_t* rects;
+    int count = vga_get_dirty_rects(&rects);
+    
+    for (int i = 0; i < count; i++)
+    {
+        vga_set_clip(&rects[i]);
+        
+        // A shaken layer leaves a strip of the region uncovered
+        if (game.screen_shake_x != 0 || game.screen_shake_y != 0)
+        {
+            vga_fill_rect(rects[i].x, rects[i].y, rects[i].width, rects[i].height, 0);
+        }
+        
+        PROFILE(PROFILE_DRAW_BRICKS,
+                vga_blit(game.screen_shake_x, game.screen_shake_y, VGA_WIDTH, VGA_HEIGHT,
+                         static_layer, VGA_WIDTH));
+        
+        PROFILE(PROFILE_DRAW_PADDLE, draw_paddle());
+        PROFILE(PROFILE_DRAW_BALLS, draw_balls());
+        PROFILE(PROFILE_DRAW_POWERUPS, draw_powerups());
+        PROFILE(PROFILE_DRAW_LASERS, draw_lasers());
+        PROFILE(PROFILE_DRAW_PARTICLES, draw_particles());
+        PROFILE(PROFILE_DRAW_HUD, draw_hud());
+    }
+    
+    vga_reset_clip();
+}
@@ -17,8 +17,12 @@
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
+#include "graphics/palette.h"
 #include "timer/timer.h"
 #include "breakout.h"
+#include "breakout_events.h"
+#include "breakout_profile.h"
+#include "breakout_replay.h"
 
 /* ============================================================================
  * GLOBAL GAME STATE
@@ -44,7 +48,8 @@ level_t levels[MAX_LEVELS] = {
         },
         .colors = {4, 12, 14, 2, 1},  // Red, Light Red, Yellow, Green, Blue
         .ball_speed = 2,
-        .name = "CLASSIC"
+        .name = "CLASSIC",
+        .song = "0:/LEVEL1.SNG"
     },
     
     // LEVEL 2: CHECKERBOARD - Alternating pattern, harder bricks
@@ -58,7 +63,8 @@ level_t levels[MAX_LEVELS] = {
         },
         .colors = {12, 12, 14, 14, 2},
         .ball_speed = 3,  // Faster!
-        .name = "CHECKERBOARD"
+        .name = "CHECKERBOARD",
+        .song = "0:/LEVEL2.SNG"
     },
     
     // LEVEL 3: PYRAMID - Triangle shape, mixed difficulty
@@ -72,7 +78,8 @@ level_t levels[MAX_LEVELS] = {
         },
         .colors = {4, 12, 14, 2, 1},
         .ball_speed = 3,
-        .name = "PYRAMID"
+        .name = "PYRAMID",
+        .song = "0:/LEVEL3.SNG"
     },
     
     // LEVEL 4: BOSS - Full wall of tough bricks!
@@ -86,7 +93,8 @@ level_t levels[MAX_LEVELS] = {
         },
         .colors = {4, 4, 12, 12, 14},
         .ball_speed = 4,  // Fastest!
-        .name = "BOSS"
+        .name = "BOSS",
+        .song = "0:/LEVEL4.SNG"
     }
 };
 
@@ -102,15 +110,20 @@ extern void init_balls();
 extern void update_balls();
 extern void update_bricks();
 extern bool check_level_complete();
+extern void brick_destroyed(int row, int col);
+extern bool brick_cells_in_rect(int x, int y, int width, int height,
+                                int* row_first, int* row_last, int* col_first, int* col_last);
 
 // From breakout_powerups.c
 extern void update_powerups();
 
 // From breakout_particles.c
 extern void update_particles();
+extern int effect_random_range(int min, int max);
 
 // From breakout_audio.c
-extern void update_music();
+extern void load_music();
+extern void update_music(bool playing);
 extern void stop_sound();
 
 // From breakout_graphics.c
@@ -121,6 +134,9 @@ extern void draw_paddle();
 extern void draw_powerups();
 extern void draw_lasers();
 extern void draw_particles();
+extern void render_frame();
+extern void invalidate_screen();
+extern void mark_brick_dirty(int row, int col);
 
 // From breakout_ui.c
 extern void draw_hud();
@@ -153,25 +169,22 @@ void shoot_laser(player_t* player)
         return;
     }
     
-    // Find an inactive laser slot
-    for (int i = 0; i < MAX_LASERS; i++)
+    // Take a free laser slot (none left: no shot)
+    laser_t* laser = laser_pool_spawn(&player->lasers);
+    if (!laser)
     {
-        if (!player->lasers[i].active)
-        {
-            // Fire laser from center of paddle
-            player->lasers[i].x = player->paddle_x + player->paddle_width / 2;
-            player->lasers[i].y = PADDLE_Y - 5;
-            player->lasers[i].active = true;
-            
-            // Start cooldown
-            player->laser_cooldown = PADDLE_LASER_COOLDOWN;
-            
-            // Play sound
-            play_sound(1500, 30);
-            
-            return;
-        }
+        return;
     }
+    
+    // Fire laser from center of paddle
+    laser->x = player->paddle_x + player->paddle_width / 2;
+    laser->y = PADDLE_Y - 5;
+    
+    // Start cooldown
+    player->laser_cooldown = PADDLE_LASER_COOLDOWN;
+    
+    // Play sound
+    play_sound(1500, 30);
 }
 
 /*
@@ -190,71 +203,57 @@ void update_lasers()
     }
     
     // Update each laser
-    for (int i = 0; i < MAX_LASERS; i++)
+    laser_t* laser;
+    POOL_FOR_EACH(&player->lasers, laser)
     {
-        if (!player->lasers[i].active)
-        {
-            continue;
-        }
-        
         // Move laser upward
-        player->lasers[i].y -= 5;
+        laser->y -= 5;
         
-        // Check collision with bricks
-        for (int row = 0; row < BRICK_ROWS; row++)
+        // The beam covered [y, y + 5) this frame. Only the column under it
+        // can be hit, and walking that column bottom-up finds the first
+        // brick in the beam's path.
+        int row_first, row_last, col, last_col;
+        if (brick_cells_in_rect(laser->x, laser->y, 1, 5,
+                                &row_first, &row_last, &col, &last_col) &&
+            laser->x < BRICK_X(col) + BRICK_WIDTH)    // Not in the gap
         {
-            for (int col = 0; col < BRICK_COLS; col++)
+            for (int row = row_last; row >= row_first; row--)
             {
-                if (game.bricks[row][col].health == 0)
+                PROFILE_COUNT(PROFILE_COUNT_COLLISION_TESTS, 1);
+                
+                int brick_y = BRICK_Y(row);
+                if (game.bricks[row][col].health == 0 ||
+                    laser->y >= brick_y + BRICK_HEIGHT ||
+                    laser->y + 5 <= brick_y)
                 {
                     continue;
                 }
                 
-                int brick_x = col * (BRICK_WIDTH + 2) + 5;
-                int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_START_Y;
+                // Hit a brick!
+                game.bricks[row][col].health--;
+                mark_brick_dirty(row, col);
+                laser_pool_free(&player->lasers, laser);
                 
-                // Simple collision check
-                if (player->lasers[i].x >= brick_x && 
-                    player->lasers[i].x < brick_x + BRICK_WIDTH &&
-                    player->lasers[i].y >= brick_y && 
-                    player->lasers[i].y < brick_y + BRICK_HEIGHT)
+                // Check if brick destroyed (scored like a ball hit once
+                // the step is done)
+                if (game.bricks[row][col].health == 0)
+                {
+                    brick_destroyed(row, col);
+                    events_push_laser_hit(EVENT_BRICK_DESTROYED, row, col);
+                }
+                else
                 {
-                    // Hit a brick!
-                    game.bricks[row][col].health--;
-                    player->lasers[i].active = false;
-                    
-                    // Check if brick destroyed
-                    if (game.bricks[row][col].health == 0)
-                    {
-                        // Award points
-                        player->score += 10;
-                        
-                        // External functions we need
-                        extern void spawn_explosion(int x, int y, uint8_t color);
-                        extern void spawn_powerup(int x, int y);
-                        
-                        // Visual feedback
-                        spawn_explosion(brick_x + BRICK_WIDTH/2, brick_y + BRICK_HEIGHT/2,
-                                      levels[game.level].colors[row]);
-                        spawn_powerup(brick_x, brick_y);
-                    }
-                    else
-                    {
-                        // Just damaged
-                        game.bricks[row][col].shake_timer = 5;
-                    }
-                    
-                    goto next_laser;
+                    // Just damaged
+                    events_push_laser_hit(EVENT_BRICK_DAMAGED, row, col);
                 }
+                break;
             }
         }
         
-        next_laser:
-        
         // Remove laser if it went off top of screen
-        if (player->lasers[i].y < 0)
+        if (laser->active && laser->y < 0)
         {
-            player->lasers[i].active = false;
+            laser_pool_free(&player->lasers, laser);
         }
     }
 }
@@ -281,7 +280,7 @@ static void handle_input(key_event_t* event)
     {
         if (event->scancode == 0x39)  // Space bar
         {
-            breakout_init(game.num_players);
+            breakout_init(game.num_players, game.mode);
         }
         return;
     }
@@ -320,6 +319,32 @@ static void handle_input(key_event_t* event)
         game.paused = !game.paused;
     }
     
+    // Toggle dirty-region debug outlines - F2 key
+    if (event->scancode == 0x3C)
+    {
+        vga_set_dirty_debug(!vga_get_dirty_debug());
+    }
+    
+#ifdef BREAKOUT_PROFILE
+    // Toggle frame-time profiler overlay - F3 key
+    if (event->scancode == 0x3D)
+    {
+        profile_toggle_overlay();
+    }
+#endif
+    
+    // Toggle frame pacing (vsync-locked 70 Hz / fixed 60 Hz) - F4 key
+    if (event->scancode == 0x3E)
+    {
+        vga_set_pacing(vga_get_pacing() == VGA_PACING_VSYNC ? VGA_PACING_60HZ : VGA_PACING_VSYNC);
+    }
+    
+    // Toggle balls bouncing off each other - B key
+    if (event->scancode == 0x30)
+    {
+        game.ball_collisions = !game.ball_collisions;
+    }
+    
     // Toggle music - M key
     if (event->scancode == 0x32)
     {
@@ -343,19 +368,20 @@ static void handle_input(key_event_t* event)
  * 
  * Parameters:
  *   num_players - 1 for single player, 2 for turn-based multiplayer
+ *   mode        - Classic game or ball storm
  */
-void breakout_init(int num_players)
+void breakout_init(int num_players, game_mode_t mode)
 {
     // Set number of players (cap at MAX_PLAYERS)
     game.num_players = (num_players <= MAX_PLAYERS) ? num_players : 1;
+    game.mode = mode;
+    game.ball_collisions = (mode == GAME_MODE_STORM);  // B toggles it
     game.current_player = 0;  // Start with player 1
     game.level = 0;  // Start at level 1
     game.all_players_done = false;
     game.paused = false;
     game.sound_enabled = true;
     game.ball_speed_multiplier = 0;  // Normal speed
-    game.music_note = 0;
-    game.music_timer = 0;
     game.screen_shake_timer = 0;
     game.screen_shake_x = 0;
     game.screen_shake_y = 0;
@@ -372,10 +398,7 @@ void breakout_init(int num_players)
         game.players[p].turn_complete = false;
         
         // Deactivate all lasers
-        for (int i = 0; i < MAX_LASERS; i++)
-        {
-            game.players[p].lasers[i].active = false;
-        }
+        laser_pool_init(&game.players[p].lasers);
     }
     
     // Initialize game objects
@@ -383,16 +406,94 @@ void breakout_init(int num_players)
     init_balls();
     
     // Deactivate all power-ups
-    for (int i = 0; i < MAX_POWERUPS; i++)
+    powerup_pool_init(&game.powerups);
+    
+    // No particles, and nothing left over from the last game to handle
+    game.particles.count = 0;
+    events_clear();
+}
+
+/* ============================================================================
+ * SIMULATION STEP
+ * ============================================================================
+ */
+
+/*
+ * breakout_step - Advance the game by one fixed simulation step
+ * 
+ * Balls move every step, everything else once per 60 Hz tick. Returns true
+ * when this step cleared the level: the next level is already set up and
+ * only its start screen is left to show. Beating the last level ends the
+ * player's turn instead.
+ */
+bool breakout_step()
+{
+    bool tick = (game.sim_steps % SIM_SUBSTEPS == 0);
+    bool level_cleared = false;
+    
+    ball_t* ball;
+    POOL_FOR_EACH(&game.balls, ball)
     {
-        game.powerups[i].active = false;
+        ball->prev_x = ball->x;
+        ball->prev_y = ball->y;
     }
     
-    // Deactivate all particles
-    for (int i = 0; i < MAX_PARTICLES; i++)
+    PROFILE(PROFILE_UPDATE_BALLS, update_balls());
+    
+    if (tick)
     {
-        game.particles[i].active = false;
+        PROFILE(PROFILE_UPDATE_BRICKS, update_bricks());
+        PROFILE(PROFILE_UPDATE_POWERUPS, update_powerups());
+        PROFILE(PROFILE_UPDATE_PARTICLES, update_particles());
+        PROFILE(PROFILE_UPDATE_LASERS, update_lasers());
+        
+        // Update screen shake
+        if (game.screen_shake_timer > 0)
+        {
+            game.screen_shake_timer--;
+            
+            // Random shake offset
+            game.screen_shake_x = effect_random_range(-2, 2);
+            game.screen_shake_y = effect_random_range(-2, 2);
+        }
+        else
+        {
+            game.screen_shake_x = 0;
+            game.screen_shake_y = 0;
+        }
     }
+    
+    // Score, power-up drops, sound and effects for what happened above
+    PROFILE(PROFILE_EVENTS, events_drain());
+    
+    game.sim_steps++;
+    
+    // Check if level complete
+    if (check_level_complete())
+    {
+        game.level++;
+        
+        // A ball storm keeps going: after the last level comes the first
+        if (game.level >= MAX_LEVELS && game.mode == GAME_MODE_STORM)
+        {
+            game.level = 0;
+        }
+        
+        if (game.level >= MAX_LEVELS)
+        {
+            // Player beat all levels!
+            game.players[game.current_player].turn_complete = true;
+        }
+        else
+        {
+            // Next level
+            init_bricks();
+            init_balls();
+            level_cleared = true;
+        }
+    }
+    
+    return level_cleared;
 }
 
 /* ============================================================================
@@ -400,6 +501,58 @@ void breakout_init(int num_players)
  * ============================================================================
  */
 
+/*
+ * next_event - Next key event for the game loop
+ * 
+ * Normally from the keyboard, logged when a recording is running. During a
+ * replay the events come from the log instead, and only ESC still gets
+ * through from the keyboard (to stop watching).
+ */
+static bool next_event(key_event_t* event)
+{
+    if (replay_mode() == REPLAY_PLAYING)
+    {
+        key_event_t key;
+        while (keyboard_get_event(&key))
+        {
+            if (key.pressed && key.scancode == 0x01)
+            {
+                *event = key;
+                return true;
+            }
+        }
+        return replay_next_key(event);
+    }
+    
+    if (!keyboard_get_event(event))
+    {
+        return false;
+    }
+    replay_record_key(event);
+    return true;
+}
+
+/*
+ * screen_timed_out - Has a timed screen (level start, countdown, turn
+ * change) run its course?
+ * 
+ * Recordings log the moment, and replays end the screen exactly there
+ * instead of waiting for the clock.
+ */
+static bool screen_timed_out(bool elapsed)
+{
+    if (replay_mode() == REPLAY_PLAYING)
+    {
+        return replay_advance_due();
+    }
+    
+    if (elapsed)
+    {
+        replay_record_advance();
+    }
+    return elapsed;
+}
+
 /*
  * breakout_run - The main game loop
  * 
@@ -409,12 +562,14 @@ void breakout_init(int num_players)
  * 3. Renders everything
  * 4. Manages transitions between states
  * 
- * Runs at 60 FPS (updates every 16ms)
+ * The game is simulated in fixed steps of 1/SIM_RATE_HZ seconds and drawn
+ * once per presented frame: 60 FPS, or 70 FPS when locked to the VGA
+ * refresh (see vga_set_pacing). A headless replay draws nothing and runs
+ * as many steps as the CPU allows.
  */
 void breakout_run()
 {
-    uint32_t last_update = timer_get_ticks();
-    uint32_t sound_timer = 0;
+    bool headless = replay_headless();
     
     // State machine flags
     bool showing_transition = false;
@@ -433,17 +588,66 @@ void breakout_run()
     uint32_t countdown_start = 0;
     bool countdown_drawn = false;
     
+    // Fixed-step simulation clock
+    bool sim_running = false;
+    uint32_t sim_last_ticks = 0;
+    uint32_t sim_accumulator = 0;
+    
+    // Songs are read from disk once, before the first level
+    load_music();
+    
     // Initialize level start timer
     level_start_time = timer_get_ticks();
     
     // Main game loop - runs forever until ESC pressed
     while (1)
     {
+        // A replay stops at the end of its log
+        if (replay_finished())
+        {
+            stop_sound();
+            return;
+        }
+        
+        // ====================================================================
+        // TURN SWITCHING (2-PLAYER MODE)
+        // ====================================================================
+        // Done before reading input, so keys handled after a turn ends are
+        // always handled after the switch. A replay delivers all events
+        // logged at one step together and relies on that order.
+        if (game.players[game.current_player].turn_complete && !showing_transition)
+        {
+            if (game.current_player < game.num_players - 1)
+            {
+                // Next player's turn
+                game.current_player++;
+                showing_transition = true;
+                transition_start = timer_get_ticks();
+                transition_drawn = false;
+                
+                // Reset game state for next player (level first: the
+                // bricks are laid out from it)
+                game.level = 0;  // Start from level 1
+                init_bricks();
+                init_balls();
+                game.ball_speed_multiplier = 0;
+                
+                // Clear power-ups
+                powerup_pool_init(&game.powerups);
+            }
+            else
+            {
+                // All players finished!
+                game.all_players_done = true;
+                winner_drawn = false;
+            }
+        }
+        
         // ====================================================================
         // INPUT HANDLING
         // ====================================================================
         key_event_t event;
-        while (keyboard_get_event(&event))
+        while (next_event(&event))
         {
             // ESC key - exit game
             if (event.pressed && event.scancode == 0x01)
@@ -456,13 +660,24 @@ void breakout_run()
             if (event.pressed && showing_level_start)
             {
                 showing_level_start = false;
+                
+                // Fade out, then let the first game frame repaint everything
+                // and fade it in
+                if (!headless)
+                {
+                    palette_fade_to(0, 0, 0, 250);
+                    palette_fade_wait();
+                    palette_fade_from(250);
+                }
+                invalidate_screen();
+                vga_reset_pacing();
                 continue;
             }
             
             // Restart game after game over
             if (event.pressed && event.scancode == 0x39 && game.all_players_done)
             {
-                breakout_init(game.num_players);
+                breakout_init(game.num_players, game.mode);
                 winner_drawn = false;
                 transition_drawn = false;
                 showing_transition = false;
@@ -477,29 +692,66 @@ void breakout_run()
             handle_input(&event);
         }
         
+        // Paused or on the winner screen, a replay only moves on through
+        // logged events. None due means it has diverged from the log.
+        if (replay_mode() == REPLAY_PLAYING && (game.paused || game.all_players_done) &&
+            !replay_event_due())
+        {
+            stop_sound();
+            return;
+        }
+        
         uint32_t current_ticks = timer_get_ticks();
         
+        bool on_screen = showing_level_start || showing_countdown || showing_transition ||
+                         game.all_players_done;
+        
+        // The level's song plays (from the timer interrupt) while the game does
+        update_music(!on_screen && !game.paused);
+        
+        // The screens below present only once, so keep palette fades and
+        // cycles running from here
+        if (on_screen)
+        {
+            if (!headless)
+            {
+                palette_sync();
+            }
+            sim_running = false;  // Game time starts again when play resumes
+        }
+        
         // ====================================================================
         // LEVEL START SCREEN
         // ====================================================================
         if (showing_level_start)
         {
-            if (!level_start_drawn)
-            {
-                draw_level_start_screen();
-                level_start_drawn = true;
-                level_start_time = current_ticks;  // Start timer when screen is drawn
-            }
-            
-            // Auto-advance after 3 seconds OR on any keypress
-            if (current_ticks - level_start_time >= 3000)
+            // Auto-advance after 3 seconds OR on any keypress (checked before
+            // drawing, so replays go straight past)
+            if (screen_timed_out(level_start_drawn && current_ticks - level_start_time >= 3000))
             {
                 showing_level_start = false;
+                
+                // Fade to black instead of cutting (the countdown fades in)
+                if (!headless)
+                {
+                    palette_fade_to(0, 0, 0, 250);
+                    palette_fade_wait();
+                }
+                
                 // Start countdown after level screen
                 showing_countdown = true;
                 countdown_number = 3;
-                countdown_start = current_ticks;
+                countdown_start = timer_get_ticks();
                 countdown_drawn = false;
+                continue;
+            }
+            
+            if (!level_start_drawn)
+            {
+                draw_level_start_screen();
+                vga_present();
+                level_start_drawn = true;
+                level_start_time = current_ticks;  // Start timer when screen is drawn
             }
             continue;
         }
@@ -513,11 +765,23 @@ void breakout_run()
             uint32_t elapsed = current_ticks - countdown_start;
             uint32_t seconds = elapsed / 1000;
             
+            if (screen_timed_out(seconds >= 4))
+            {
+                // Countdown finished, start game!
+                showing_countdown = false;
+                vga_reset_pacing();
+                invalidate_screen();  // Back buffer still holds the countdown
+                palette_fade_from(0); // Already faded in, unless a replay skipped "3"
+                continue;
+            }
+            
             if (seconds == 0 && countdown_number == 3)
             {
                 if (!countdown_drawn)
                 {
                     draw_countdown(3);
+                    vga_present();
+                    palette_fade_from(250);
                     play_sound(800, 100);
                     countdown_drawn = true;
                 }
@@ -532,6 +796,7 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(2);
+                    vga_present();
                     play_sound(900, 100);
                     countdown_drawn = true;
                 }
@@ -546,6 +811,7 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(1);
+                    vga_present();
                     play_sound(1000, 100);
                     countdown_drawn = true;
                 }
@@ -560,65 +826,21 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(0);  // GO!
+                    vga_present();
                     play_sound(1200, 200);
                     countdown_drawn = true;
                 }
             }
-            else if (seconds >= 4)
-            {
-                // Countdown finished, start game!
-                showing_countdown = false;
-                last_update = current_ticks;
-            }
             continue;
         }
         
-        // ====================================================================
-        // TURN SWITCHING (2-PLAYER MODE)
-        // ====================================================================
-        if (game.players[game.current_player].turn_complete && !showing_transition)
-        {
-            if (game.current_player < game.num_players - 1)
-            {
-                // Next player's turn
-                game.current_player++;
-                showing_transition = true;
-                transition_start = current_ticks;
-                transition_drawn = false;
-                
-                // Reset game state for next player
-                init_bricks();
-                init_balls();
-                game.ball_speed_multiplier = 0;
-                game.level = 0;  // Start from level 1
-                
-                // Clear power-ups
-                for (int i = 0; i < MAX_POWERUPS; i++)
-                {
-                    game.powerups[i].active = false;
-                }
-            }
-            else
-            {
-                // All players finished!
-                game.all_players_done = true;
-                winner_drawn = false;
-            }
-        }
-        
         // ====================================================================
         // TURN TRANSITION SCREEN
         // ====================================================================
         if (showing_transition)
         {
-            if (!transition_drawn)
-            {
-                draw_turn_transition();
-                transition_drawn = true;
-            }
-            
             // Show for 2 seconds
-            if (current_ticks - transition_start >= 2000)
+            if (screen_timed_out(transition_drawn && current_ticks - transition_start >= 2000))
             {
                 showing_transition = false;
                 showing_level_start = true;  // Show level screen for new player
@@ -626,6 +848,14 @@ void breakout_run()
                 // Reset countdown for new player
                 showing_countdown = false;
                 countdown_number = 3;
+                continue;
+            }
+            
+            if (!transition_drawn)
+            {
+                draw_turn_transition();
+                vga_present();
+                transition_drawn = true;
             }
             continue;
         }
@@ -635,89 +865,84 @@ void breakout_run()
         // ====================================================================
         if (game.all_players_done)
         {
-            if (!winner_drawn)
+            if (!winner_drawn && !headless)
             {
                 draw_winner_screen();
+                vga_present();
                 winner_drawn = true;
             }
             continue;  // Don't update game, just wait for restart
         }
         
         // ====================================================================
-        // GAME UPDATE (60 FPS)
+        // GAME UPDATE (fixed steps, however long the last frame took)
         // ====================================================================
-        if (current_ticks - last_update >= 16)  // 16ms = ~60 FPS
+        // Real time is banked in SIM_STEP_COST units per step: every elapsed
+        // millisecond adds SIM_RATE_HZ. All integers, so there is no drift,
+        // and the step size never depends on how long a frame took.
+        if (!sim_running)
+        {
+            sim_accumulator = 0;
+            sim_last_ticks = current_ticks;
+            sim_running = true;
+        }
+        if (game.paused)
+        {
+            sim_last_ticks = current_ticks;  // Paused time doesn't count
+        }
+        sim_accumulator += (current_ticks - sim_last_ticks) * SIM_RATE_HZ;
+        sim_last_ticks = current_ticks;
+        
+        // Headless replays don't wait for the clock
+        if (headless && !game.paused)
+        {
+            sim_accumulator = SIM_STEP_COST * SIM_MAX_STEPS;
+        }
+        
+        // A replay stops stepping as soon as a logged event is due
+        int steps = 0;
+        while (sim_accumulator >= SIM_STEP_COST && !replay_event_due())
         {
-            last_update = current_ticks;
+            // Too far behind: drop the rest instead of falling further back
+            if (steps == SIM_MAX_STEPS)
+            {
+                sim_accumulator %= SIM_STEP_COST;
+                break;
+            }
             
-            if (!game.paused)
+            sim_accumulator -= SIM_STEP_COST;
+            steps++;
+            
+            if (breakout_step())
             {
-                // Update all game systems
-                update_balls();
-                update_bricks();
-                update_powerups();
-                update_particles();
-                update_lasers();
-                
-                // Check if level complete
-                if (check_level_complete())
-                {
-                    game.level++;
-                    
-                    if (game.level >= MAX_LEVELS)
-                    {
-                        // Player beat all levels!
-                        game.players[game.current_player].turn_complete = true;
-                    }
-                    else
-                    {
-                        // Next level
-                        init_bricks();
-                        init_balls();
-                        showing_level_start = true;
-                        level_start_drawn = false;
-                        // Reset countdown for next level
-                        showing_countdown = false;
-                        countdown_number = 3;
-                    }
-                }
-                
-                // Update screen shake
-                if (game.screen_shake_timer > 0)
-                {
-                    game.screen_shake_timer--;
-                    
-                    // Random shake offset
-                    extern int random_range(int min, int max);
-                    game.screen_shake_x = random_range(-2, 2);
-                    game.screen_shake_y = random_range(-2, 2);
-                }
-                else
-                {
-                    game.screen_shake_x = 0;
-                    game.screen_shake_y = 0;
-                }
-                
-                // Update music
-                sound_timer++;
-                if (sound_timer >= 5)
-                {
-                    sound_timer = 0;
-                    update_music();
-                }
+                // Level cleared, the next one is set up - show its screen
+                showing_level_start = true;
+                level_start_drawn = false;
+                // Reset countdown for next level
+                showing_countdown = false;
+                countdown_number = 3;
             }
             
-            // ================================================================
-            // RENDER EVERYTHING
-            // ================================================================
-            vga_clear(0);  // Clear screen to black
-            draw_bricks();
-            draw_paddle();
-            draw_balls();
-            draw_powerups();
-            draw_lasers();
-            draw_particles();
-            draw_hud();
+            // A new screen or turn takes over - stop stepping
+            if (showing_level_start || game.players[game.current_player].turn_complete)
+            {
+                break;
+            }
+        }
+        
+        // Draw the balls part of the way to their next step
+        game.sim_blend = sim_accumulator * SIM_BLEND_FULL / SIM_STEP_COST;
+        
+        // ====================================================================
+        // RENDER EVERYTHING
+        // ====================================================================
+        // Only the regions that changed are redrawn into the back
+        // buffer, and only those are copied to the screen
+        if (!headless)
+        {
+            render_frame();
+            vga_present_synced();
+            PROFILE_FRAME_END();
         }
     }
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "graphics/vga.h"
 #include "timer/timer.h"
 #include "breakout_menu.h"
+#include "breakout_text.h"
 
 // External function we need
 extern void vga_fill_rect(int x, int y, int width, int height, uint8_t color);
@@ -19,204 +20,6 @@ extern void vga_fill_rect(int x, int y, int width, int height, uint8_t color);
 // Menu state
 static menu_state_t menu;
 
-/* ============================================================================
- * SIMPLE PIXEL FONT FOR MENU TEXT
- * ============================================================================
- * Drawing letters pixel by pixel for a retro look!
- */
-
-/*
- * draw_letter - Draw a single letter in pixel art style
- * 
- * This draws simple block letters. Not fancy, but readable!
- */
-static void draw_letter(int x, int y, char letter, uint8_t color)
-{
-    // Make letter uppercase
-    if (letter >= 'a' && letter <= 'z')
-    {
-        letter = letter - 32;
-    }
-    
-    switch (letter)
-    {
-        case '1':
-            vga_fill_rect(x + 2, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            vga_fill_rect(x, y, 2, 3, color);
-            break;
-            
-        case '2':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 5, color);
-            vga_fill_rect(x, y + 4, 6, 2, color);
-            vga_fill_rect(x, y + 6, 2, 4, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '3':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '4':
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'A':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 6, 6, 2, color);
-            break;
-            
-        case 'B':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 5, 2, color);
-            vga_fill_rect(x, y + 5, 5, 2, color);
-            vga_fill_rect(x, y + 10, 5, 2, color);
-            vga_fill_rect(x + 4, y, 2, 5, color);
-            vga_fill_rect(x + 4, y + 6, 2, 4, color);
-            break;
-            
-        case 'C':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'D':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 5, 2, color);
-            vga_fill_rect(x, y + 10, 5, 2, color);
-            vga_fill_rect(x + 4, y + 2, 2, 8, color);
-            break;
-            
-        case 'E':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y + 5, 5, 2, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'H':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'I':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 2, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'K':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 4, color);
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            vga_fill_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'L':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'M':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 5, y, 2, 12, color);
-            vga_fill_rect(x + 2, y + 2, 1, 3, color);
-            vga_fill_rect(x + 4, y + 2, 1, 3, color);
-            break;
-            
-        case 'N':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 5, y, 2, 12, color);
-            vga_fill_rect(x + 1, y + 3, 2, 2, color);
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            vga_fill_rect(x + 3, y + 7, 2, 2, color);
-            break;
-            
-        case 'O':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'P':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'R':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x + 4, y + 7, 2, 5, color);
-            break;
-            
-        case 'S':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x + 4, y + 6, 2, 4, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'T':
-            vga_fill_rect(x, y, 8, 2, color);
-            vga_fill_rect(x + 3, y, 2, 12, color);
-            break;
-            
-        case 'V':
-            vga_fill_rect(x, y, 2, 8, color);
-            vga_fill_rect(x + 5, y, 2, 8, color);
-            vga_fill_rect(x + 1, y + 8, 2, 2, color);
-            vga_fill_rect(x + 4, y + 8, 2, 2, color);
-            vga_fill_rect(x + 2, y + 10, 2, 2, color);
-            break;
-            
-        case 'Y':
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x + 1, y + 5, 4, 2, color);
-            vga_fill_rect(x + 2, y + 6, 2, 6, color);
-            break;
-            
-        case ' ':
-            // Space - do nothing
-            break;
-            
-        default:
-            // Unknown character - draw a small dot
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            break;
-    }
-}
-
-/*
- * draw_text - Draw a string of text
- */
-static void draw_text(int x, int y, const char* text, uint8_t color)
-{
-    int cursor_x = x;
-    
-    for (int i = 0; text[i] != '\0'; i++)
-    {
-        draw_letter(cursor_x, y, text[i], color);
-        cursor_x += 8;  // Move to next character position
-    }
-}
-
 /* ============================================================================
  * TITLE LOGO
  * ============================================================================
@@ -342,17 +145,7 @@ static void draw_animated_bricks()
         if (y >= 0 && y < 180)
         {
             vga_fill_rect(x, y, 25, 10, brick_colors[i]);
-            
-            for (int j = 0; j < 25; j++)
-            {
-                vga_set_pixel(x + j, y, 0);
-                vga_set_pixel(x + j, y + 9, 0);
-            }
-            for (int j = 0; j < 10; j++)
-            {
-                vga_set_pixel(x, y + j, 0);
-                vga_set_pixel(x + 24, y + j, 0);
-            }
+            vga_draw_border(x, y, 25, 10, 0);
         }
     }
 }
@@ -364,7 +157,7 @@ static void draw_animated_bricks()
 
 static void draw_menu_options()
 {
-    int menu_y = 135;
+    int menu_y = 122;
     int menu_x = 100;
     
     // Draw each menu option
@@ -376,30 +169,34 @@ static void draw_menu_options()
         // Draw selection highlight
         if (i == menu.selected)
         {
-            vga_fill_rect(menu_x - 5, menu_y + i * 15 - 2, 140, 12, bg_color);
-            vga_fill_rect(menu_x - 3, menu_y + i * 15, 136, 8, 0);
+            vga_fill_rect(menu_x - 5, menu_y + i * 13 - 2, 140, 12, bg_color);
+            vga_fill_rect(menu_x - 3, menu_y + i * 13, 136, 8, 0);
         }
         
         // Draw menu text
         int text_x = menu_x;
-        int text_y = menu_y + i * 15;
+        int text_y = menu_y + i * 13;
         
         switch (i)
         {
             case MENU_SINGLE_PLAYER:
-                draw_text(text_x, text_y, "1 PLAYER", color);
+                text_draw(text_x, text_y, "1 PLAYER", TEXT_FONT_LARGE, color);
                 break;
                 
             case MENU_TWO_PLAYER:
-                draw_text(text_x, text_y, "2 PLAYERS", color);
+                text_draw(text_x, text_y, "2 PLAYERS", TEXT_FONT_LARGE, color);
+                break;
+                
+            case MENU_BALL_STORM:
+                text_draw(text_x, text_y, "BALL STORM", TEXT_FONT_LARGE, color);
                 break;
                 
             case MENU_OPTIONS:  // FIXED: was MENU_SETTINGS
-                draw_text(text_x, text_y, "SETTINGS", color);
+                text_draw(text_x, text_y, "SETTINGS", TEXT_FONT_LARGE, color);
                 break;
                 
             case MENU_EXIT:
-                draw_text(text_x, text_y, "EXIT", color);
+                text_draw(text_x, text_y, "EXIT", TEXT_FONT_LARGE, color);
                 break;
         }
         
@@ -408,7 +205,7 @@ static void draw_menu_options()
         {
             int arrow_offset = (menu.animation_frame / 10) % 3;
             int arrow_x = menu_x - 12 - arrow_offset;
-            int arrow_y = menu_y + i * 15 + 2;
+            int arrow_y = menu_y + i * 13 + 2;
             
             vga_fill_rect(arrow_x, arrow_y, 3, 5, 14);
             vga_fill_rect(arrow_x + 3, arrow_y + 1, 2, 3, 14);
@@ -424,7 +221,7 @@ static void draw_menu_options()
     int info_y = footer_y + 5;
     uint8_t info_color = ((menu.animation_frame / 30) % 2 == 0) ? 15 : 8;
     
-    draw_text(70, info_y, "PRESS ENTER TO START", info_color);
+    text_draw(70, info_y, "PRESS ENTER TO START", TEXT_FONT_LARGE, info_color);
 }
 
 /* ============================================================================
@@ -438,6 +235,7 @@ void menu_show()
     draw_animated_bricks();
     draw_title_logo();
     draw_menu_options();
+    vga_present_synced();
 }
 
 int menu_run()
@@ -445,8 +243,9 @@ int menu_run()
     menu.selected = MENU_SINGLE_PLAYER;
     menu.in_menu = true;
     menu.animation_frame = 0;
+    menu.ball_storm = false;
     
-    uint32_t last_update = timer_get_ticks();
+    vga_reset_pacing();
     
     while (menu.in_menu)
     {
@@ -476,6 +275,9 @@ int menu_run()
                         return 1;
                     case MENU_TWO_PLAYER:
                         return 2;
+                    case MENU_BALL_STORM:
+                        menu.ball_storm = true;
+                        return 1;
                     case MENU_OPTIONS:  // FIXED: was MENU_SETTINGS
                         // Not implemented yet
                         break;
@@ -489,15 +291,15 @@ int menu_run()
             }
         }
         
-        // Update animation
-        uint32_t current_ticks = timer_get_ticks();
-        if (current_ticks - last_update >= 16)
-        {
-            last_update = current_ticks;
-            menu.animation_frame++;
-            menu_show();
-        }
+        // Update animation (menu_show waits for the next frame slot)
+        menu.animation_frame++;
+        menu_show();
     }
     
     return 0;
+}
+
+bool menu_ball_storm()
+{
+    return menu.ball_storm;
 }
\ No newline at end of file
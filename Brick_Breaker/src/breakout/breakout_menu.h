@@ -8,9 +8,10 @@
 typedef enum {
     MENU_SINGLE_PLAYER = 0,
     MENU_TWO_PLAYER = 1,
-    MENU_OPTIONS = 2,
-    MENU_EXIT = 3,
-    MENU_COUNT = 4
+    MENU_BALL_STORM = 2,
+    MENU_OPTIONS = 3,
+    MENU_EXIT = 4,
+    MENU_COUNT = 5
 } menu_option_t;
 
 // Menu state
@@ -18,10 +19,12 @@ typedef struct {
     menu_option_t selected;
     bool in_menu;
     int animation_frame;
+    bool ball_storm;   // Ball storm was picked
 } menu_state_t;
 
 // Public functions
 void menu_show();  // Returns selected option (1 or 2 players, or 0 for exit)
 int menu_run();    // Run the menu, return number of players (or 0 to exit)
+bool menu_ball_storm();   // Did the last menu_run start a ball storm?
 
 #endif // BREAKOUT_MENU_H
\ No newline at end of file
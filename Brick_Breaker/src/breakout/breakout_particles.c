@@ -15,7 +15,11 @@
 
 // External references
 extern game_state_t game;
-extern void play_sound(int frequency, int duration_ms);
+
+// Random generator states (both restarted by random_seed): one for the
+// game itself, one for effects, which headless replays skip
+static uint32_t random_state = 12345;
+static uint32_t effect_state = 12345;
 
 /*
  * random_range - Generate a pseudo-random number
@@ -33,23 +37,42 @@ extern void play_sound(int frequency, int duration_ms);
  */
 int random_range(int min, int max)
 {
-    // Static variable persists between function calls
-    static uint32_t seed = 12345;
-    
     // LCG formula: seed = (a * seed + c) mod m
     // These constants are from Numerical Recipes
-    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    random_state = (random_state * 1103515245 + 12345) & 0x7FFFFFFF;
     
     // Map to our desired range
-    return min + (seed % (max - min + 1));
+    return min + (random_state % (max - min + 1));
+}
+
+/*
+ * effect_random_range - random_range for effects only
+ * 
+ * Particles, screen shake and sound pitch use this sequence, so whether
+ * they run or not never changes the game's own random numbers.
+ */
+int effect_random_range(int min, int max)
+{
+    effect_state = (effect_state * 1103515245 + 12345) & 0x7FFFFFFF;
+    return min + (effect_state % (max - min + 1));
+}
+
+/*
+ * random_seed - Restart the random sequences from a given seed
+ * 
+ * The same seed always gives the same game (used by recording/replay).
+ */
+void random_seed(uint32_t seed)
+{
+    random_state = seed & 0x7FFFFFFF;
+    effect_state = (seed ^ 0x2545F491) & 0x7FFFFFFF;   // A different sequence
 }
 
 /*
  * spawn_particle - Create a single particle
  * 
- * This adds a particle to the particle array if there's room.
- * Particles are stored in a fixed-size array, so we look for an
- * inactive slot to use.
+ * Live particles are packed at the front of the pool, so the new one just
+ * goes on the end.
  * 
  * Parameters:
  *   x, y - Starting position
@@ -59,32 +82,29 @@ int random_range(int min, int max)
  */
 void spawn_particle(int x, int y, int dx, int dy, uint8_t color, int life)
 {
-    // Search for an inactive particle slot
-    for (int i = 0; i < MAX_PARTICLES; i++)
+    particle_pool_t* pool = &game.particles;
+    
+    // All particle slots are full - that's okay, we just won't spawn this one
+    if (pool->count == MAX_PARTICLES)
     {
-        if (!game.particles[i].active)
-        {
-            // Found a free slot! Initialize it
-            game.particles[i].x = x;
-            game.particles[i].y = y;
-            game.particles[i].dx = dx;
-            game.particles[i].dy = dy;
-            game.particles[i].color = color;
-            game.particles[i].life = life;
-            game.particles[i].active = true;
-            return;  // Done!
-        }
+        return;
     }
     
-    // If we get here, all particle slots are full
-    // That's okay, we just won't spawn this particle
+    int i = pool->count++;
+    pool->x[i] = (int16_t)x;
+    pool->y[i] = (int16_t)y;
+    pool->dx[i] = (int16_t)dx;
+    pool->dy[i] = (int16_t)dy;
+    pool->color[i] = color;
+    pool->life[i] = (int16_t)life;
 }
 
 /*
  * spawn_explosion - Create an explosion effect
  * 
  * This spawns 8 particles in different directions to create a burst effect.
- * Called when a brick is destroyed.
+ * Called when a brick is destroyed or a power-up caught (the sound that goes
+ * with it is played by events_drain).
  * 
  * Parameters:
  *   x, y - Center of explosion (usually center of brick)
@@ -110,44 +130,53 @@ void spawn_explosion(int x, int y, uint8_t color)
         // Multiply by 2 to make particles move faster
         spawn_particle(x, y, dx * 2, dy * 2, color, 15);
     }
-    
-    // Play explosion sound
-    // Randomize pitch slightly for variation
-    play_sound(200 + random_range(0, 100), 50);
 }
 
 /*
- * update_particles - Update all active particles
+ * update_particles - Update all live particles
  * 
  * This is called every frame. It updates particle positions using their
- * velocity, applies gravity, and decrements their lifetime. When a particle's
- * life reaches 0, it's deactivated.
+ * velocity, applies gravity, and decrements their lifetime. Particles whose
+ * life reaches 0 are then removed.
  */
 void update_particles()
 {
-    for (int i = 0; i < MAX_PARTICLES; i++)
+    particle_pool_t* pool = &game.particles;
+    int count = pool->count;
+    
+    // Move every particle - no branches, so this loop vectorizes
+    for (int i = 0; i < count; i++)
     {
-        // Skip inactive particles
-        if (!game.particles[i].active)
-        {
-            continue;
-        }
-        
         // Apply velocity to position
-        game.particles[i].x += game.particles[i].dx;
-        game.particles[i].y += game.particles[i].dy;
+        pool->x[i] += pool->dx[i];
+        pool->y[i] += pool->dy[i];
         
         // Apply gravity (pulls particles down)
         // This makes the explosion look more natural
-        game.particles[i].dy += 1;
+        pool->dy[i] += 1;
         
         // Decrease lifetime
-        game.particles[i].life--;
-        
-        // Check if particle died
-        if (game.particles[i].life <= 0)
+        pool->life[i]--;
+    }
+    
+    // Remove dead particles: the last live particle takes the dead one's
+    // place (and is checked in turn), so the live ones stay packed
+    int i = 0;
+    while (i < count)
+    {
+        if (pool->life[i] > 0)
         {
-            game.particles[i].active = false;
+            i++;
+            continue;
         }
+        
+        count--;
+        pool->x[i] = pool->x[count];
+        pool->y[i] = pool->y[count];
+        pool->dx[i] = pool->dx[count];
+        pool->dy[i] = pool->dy[count];
+        pool->life[i] = pool->life[count];
+        pool->color[i] = pool->color[count];
     }
-}
\ No newline at end of file
+    pool->count = count;
+}
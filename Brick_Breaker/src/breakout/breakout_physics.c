@@ -14,14 +14,14 @@
 #include "graphics/vga.h"
 #include "timer/timer.h"
 #include "breakout.h"
+#include "breakout_events.h"
+#include "breakout_profile.h"
 
 // External references
 extern game_state_t game;
-extern void spawn_particle(int x, int y, int dx, int dy, uint8_t color, int life);
-extern void spawn_explosion(int x, int y, uint8_t color);
-extern void spawn_powerup(int x, int y);
-extern void play_sound(int frequency, int duration_ms);
 extern int random_range(int min, int max);
+extern void mark_brick_dirty(int row, int col);
+extern void build_brick_sprites();
 
 // Level definitions (in breakout_main.c)
 extern level_t levels[MAX_LEVELS];
@@ -53,12 +53,30 @@ void init_bricks()
 {
     level_t* level = &levels[game.level];
     
+    game.bricks_left = 0;
+    
     for (int row = 0; row < BRICK_ROWS; row++)
     {
+        for (int word = 0; word < BRICK_WORDS; word++)
+        {
+            game.brick_bits[row][word] = 0;
+        }
+        
         for (int col = 0; col < BRICK_COLS; col++)
         {
-            // Copy health from level pattern
+            // Copy health from level pattern (a ball storm needs tougher bricks)
             game.bricks[row][col].health = level->pattern[row][col];
+            if (game.mode == GAME_MODE_STORM)
+            {
+                game.bricks[row][col].health *= STORM_BRICK_HITS;
+            }
+            
+            // Standing bricks go into the occupancy bits
+            if (game.bricks[row][col].health > 0)
+            {
+                game.brick_bits[row][col / BRICK_WORD_BITS] |= 1u << (col % BRICK_WORD_BITS);
+                game.bricks_left++;
+            }
             
             // Reset animation state
             game.bricks[row][col].shake_x = 0;
@@ -66,6 +84,9 @@ void init_bricks()
             game.bricks[row][col].shake_timer = 0;
         }
     }
+    
+    // Bake this level's brick looks once instead of every frame
+    build_brick_sprites();
 }
 
 /*
@@ -78,22 +99,38 @@ void update_bricks()
 {
     for (int row = 0; row < BRICK_ROWS; row++)
     {
-        for (int col = 0; col < BRICK_COLS; col++)
+        for (int word = 0; word < BRICK_WORDS; word++)
         {
-            // If brick is shaking, apply random offset
-            if (game.bricks[row][col].shake_timer > 0)
+            uint32_t bits = game.brick_bits[row][word];
+            
+            // Only standing bricks can shake
+            while (bits != 0)
             {
-                game.bricks[row][col].shake_timer--;
+                int col = word * BRICK_WORD_BITS + BRICK_BIT_SCAN(bits);
+                bits &= bits - 1;
                 
-                // Random offset for shake effect
-                game.bricks[row][col].shake_x = random_range(-2, 2);
-                game.bricks[row][col].shake_y = random_range(-1, 1);
-            }
-            else
-            {
-                // No shake, return to normal position
-                game.bricks[row][col].shake_x = 0;
-                game.bricks[row][col].shake_y = 0;
+                // Shaking bricks move, so their cell has to be repainted
+                if (game.bricks[row][col].shake_timer > 0 ||
+                    game.bricks[row][col].shake_x != 0 || game.bricks[row][col].shake_y != 0)
+                {
+                    mark_brick_dirty(row, col);
+                }
+                
+                // If brick is shaking, apply random offset
+                if (game.bricks[row][col].shake_timer > 0)
+                {
+                    game.bricks[row][col].shake_timer--;
+                    
+                    // Random offset for shake effect
+                    game.bricks[row][col].shake_x = random_range(-2, 2);
+                    game.bricks[row][col].shake_y = random_range(-1, 1);
+                }
+                else
+                {
+                    // No shake, return to normal position
+                    game.bricks[row][col].shake_x = 0;
+                    game.bricks[row][col].shake_y = 0;
+                }
             }
         }
     }
@@ -102,223 +139,797 @@ void update_bricks()
 /*
  * check_level_complete - Are all bricks destroyed?
  * 
- * Checks if any bricks remain. If not, level is complete!
+ * The standing-brick count is kept up to date as bricks break, so this
+ * is just a check for zero.
  * 
  * Returns:
  *   true if all bricks destroyed, false otherwise
  */
 bool check_level_complete()
 {
-    for (int row = 0; row < BRICK_ROWS; row++)
+    return game.bricks_left == 0;
+}
+
+/*
+ * brick_destroyed - Take a brick out of the occupancy bits
+ * 
+ * Call this whenever a brick's health reaches 0.
+ */
+void brick_destroyed(int row, int col)
+{
+    game.brick_bits[row][col / BRICK_WORD_BITS] &= ~(1u << (col % BRICK_WORD_BITS));
+    game.bricks_left--;
+}
+
+/*
+ * brick_live_bits - Standing bricks in one word of a row, limited to a
+ * column range
+ * 
+ * Bit n of the result is column word * BRICK_WORD_BITS + n.
+ */
+uint32_t brick_live_bits(int row, int word, int col_first, int col_last)
+{
+    int first = col_first - word * BRICK_WORD_BITS;
+    int last = col_last - word * BRICK_WORD_BITS;
+    uint32_t bits = game.brick_bits[row][word];
+    
+    if (first >= BRICK_WORD_BITS || last < 0)
     {
-        for (int col = 0; col < BRICK_COLS; col++)
-        {
-            if (game.bricks[row][col].health > 0)
-            {
-                return false;  // Found a brick, not complete
-            }
-        }
+        return 0;
     }
-    return true;  // No bricks remaining!
+    if (first > 0)
+    {
+        bits &= ~0u << first;
+    }
+    if (last < BRICK_WORD_BITS - 1)
+    {
+        bits &= (2u << last) - 1;
+    }
+    return bits;
+}
+
+/*
+ * trail_point - A ball's position as a trail point (screen offset)
+ * 
+ * Clamped to the screen, which is what lets it fit in 16 bits.
+ */
+static uint16_t trail_point(const ball_t* ball)
+{
+    int x = FIXED_TO_INT(ball->x);
+    int y = FIXED_TO_INT(ball->y);
+    
+    if (x < 0) x = 0;
+    if (x > VGA_WIDTH - 1) x = VGA_WIDTH - 1;
+    if (y < 0) y = 0;
+    if (y > VGA_HEIGHT - 1) y = VGA_HEIGHT - 1;
+    
+    return (uint16_t)(y * VGA_WIDTH + x);
+}
+
+/*
+ * ball_trail_reset - Start a ball's trail on the ball itself
+ * 
+ * Call this for every newly spawned ball, so no stale trail pixels from
+ * whatever used its slot before get drawn.
+ */
+void ball_trail_reset(const ball_t* ball)
+{
+    uint16_t* trail = game.ball_trails[ball - game.balls.items];
+    uint16_t point = trail_point(ball);
+    
+    for (int t = 0; t < BALL_TRAIL_LENGTH; t++)
+    {
+        trail[t] = point;
+    }
+}
+
+/*
+ * spawn_ball - Put a new ball in play (false if there is no room)
+ */
+static bool spawn_ball(int x, int y, int dx, int dy)
+{
+    ball_t* ball = ball_pool_spawn(&game.balls);
+    if (!ball)
+    {
+        return false;
+    }
+    
+    ball->x = INT_TO_FIXED(x);
+    ball->y = INT_TO_FIXED(y);
+    ball->dx = INT_TO_FIXED(dx);
+    ball->dy = INT_TO_FIXED(dy);
+    ball->prev_x = ball->x;                // Don't draw it sliding in
+    ball->prev_y = ball->y;
+    ball_trail_reset(ball);
+    return true;
 }
 
 /*
  * init_balls - Reset balls (usually after losing a life)
  * 
- * Deactivates all balls and spawns a new one in the center.
+ * Deactivates all balls and spawns a new one in the center. A ball storm
+ * starts with STORM_BALLS instead, in a block between the bricks and the
+ * paddle, all heading up at a mix of angles.
  */
 void init_balls()
 {
     // Deactivate all balls
-    for (int i = 0; i < MAX_BALLS; i++)
+    ball_pool_init(&game.balls);
+    
+    if (game.mode == GAME_MODE_STORM)
+    {
+        // 50 to a row, 6 pixels apart (past 10 rows they start over on
+        // top of the first)
+        for (int i = 0; i < STORM_BALLS; i++)
+        {
+            int col = i % 50;
+            int row = i / 50;
+            int dx = (col % 2 == 0) ? -1 - row % 2 : 1 + row % 2;
+            
+            spawn_ball(10 + col * 6, 100 + (row % 10) * 6, dx, -BALL_SPEED);
+        }
+        return;
+    }
+    
+    // Activate first ball in center of screen, going upward
+    spawn_ball(VGA_WIDTH / 2, VGA_HEIGHT / 2, BALL_SPEED, -BALL_SPEED);
+}
+
+/* ============================================================================
+ * BRICK GRID LOOKUP
+ * ============================================================================
+ * Bricks sit on a regular grid, so a rectangle's edges convert straight to
+ * the rows and columns it overlaps with one division each. Each cell covers
+ * a brick plus the gap to its right/below, so the range is conservative and
+ * callers still test the bricks in it.
+ */
+
+/*
+ * brick_cells_in_rect - Range of grid cells a rectangle overlaps
+ * 
+ * Parameters:
+ *   x, y, width, height - The rectangle, in whole pixels
+ *   row_first, row_last, col_first, col_last - Set to the inclusive range
+ * 
+ * Returns:
+ *   false if the rectangle misses the grid entirely
+ */
+bool brick_cells_in_rect(int x, int y, int width, int height,
+                         int* row_first, int* row_last, int* col_first, int* col_last)
+{
+    int right = x + width - 1;
+    int bottom = y + height - 1;
+    
+    if (width <= 0 || height <= 0 || right < BRICK_START_X || bottom < BRICK_START_Y)
+    {
+        return false;
+    }
+    
+    // Clamp before dividing - division rounds toward zero, not down
+    *col_first = (x < BRICK_START_X) ? 0 : (x - BRICK_START_X) / BRICK_STEP_X;
+    *row_first = (y < BRICK_START_Y) ? 0 : (y - BRICK_START_Y) / BRICK_STEP_Y;
+    if (*col_first >= BRICK_COLS || *row_first >= BRICK_ROWS)
+    {
+        return false;
+    }
+    
+    *col_last = (right - BRICK_START_X) / BRICK_STEP_X;
+    *row_last = (bottom - BRICK_START_Y) / BRICK_STEP_Y;
+    if (*col_last >= BRICK_COLS)
+    {
+        *col_last = BRICK_COLS - 1;
+    }
+    if (*row_last >= BRICK_ROWS)
+    {
+        *row_last = BRICK_ROWS - 1;
+    }
+    return true;
+}
+
+/* ============================================================================
+ * SWEPT COLLISION
+ * ============================================================================
+ * A fast ball can move further in one frame than a brick is tall, so just
+ * checking for overlap after moving lets it tunnel straight through. Instead
+ * we sweep the ball's box along its motion and find the moment it first
+ * touches each obstacle. Times are in 1/256ths of the motion being tested.
+ */
+
+#define SWEEP_FULL 256                 // The whole motion
+#define SWEEP_NEVER (4 * SWEEP_FULL)   // "Not within this motion"
+#define BALL_MAX_HITS 4                // Bounces resolved per ball per step
+
+// Which faces met
+#define AXIS_X 0
+#define AXIS_Y 1
+
+/*
+ * sweep_axis - Entry and exit time of a moving span against a fixed span
+ * 
+ * Returns false if the spans can't overlap during this motion. A negative
+ * entry time means they already overlap (deeper = more negative).
+ */
+static bool sweep_axis(fixed_t pos, fixed_t size, fixed_t vel,
+                       fixed_t target, fixed_t target_size, int* entry_time, int* exit_time)
+{
+    if (vel == 0)
+    {
+        // Not moving on this axis: either always overlapping or never
+        if (pos + size <= target || pos >= target + target_size)
+        {
+            return false;
+        }
+        *entry_time = -SWEEP_NEVER;
+        *exit_time = SWEEP_NEVER;
+        return true;
+    }
+    
+    fixed_t speed = (vel > 0) ? vel : -vel;
+    fixed_t entry, exit;
+    
+    if (vel > 0)
+    {
+        entry = target - (pos + size);
+        exit = target + target_size - pos;
+    }
+    else
+    {
+        entry = pos - (target + target_size);
+        exit = pos + size - target;
+    }
+    
+    // Too far to reach this step, or already past it
+    if (entry > speed || exit <= 0)
+    {
+        return false;
+    }
+    
+    // Both distances are clamped before scaling so nothing overflows 32 bits
+    if (entry < 0)
+    {
+        *entry_time = (-entry >= speed) ? -SWEEP_NEVER : -(-entry * SWEEP_FULL / speed);
+    }
+    else
+    {
+        *entry_time = entry * SWEEP_FULL / speed;
+    }
+    *exit_time = (exit >= speed * 2) ? SWEEP_NEVER : exit * SWEEP_FULL / speed;
+    return true;
+}
+
+/*
+ * sweep_ball - When does the ball first touch a rectangle during a motion?
+ * 
+ * Parameters:
+ *   ball     - The ball (position is the start of the motion)
+ *   vx, vy   - The motion to test (fixed point pixels)
+ *   x, y, width, height - The obstacle, in whole pixels
+ *   axis     - Set to AXIS_X or AXIS_Y: which faces met
+ * 
+ * Returns:
+ *   Time of contact (0 to SWEEP_FULL), or -1 for no contact
+ */
+static int sweep_ball(const ball_t* ball, fixed_t vx, fixed_t vy,
+                      int x, int y, int width, int height, int* axis)
+{
+    int entry_x, exit_x, entry_y, exit_y;
+    
+    PROFILE_COUNT(PROFILE_COUNT_COLLISION_TESTS, 1);
+    
+    if (!sweep_axis(ball->x, INT_TO_FIXED(BALL_SIZE), vx,
+                    INT_TO_FIXED(x), INT_TO_FIXED(width), &entry_x, &exit_x) ||
+        !sweep_axis(ball->y, INT_TO_FIXED(BALL_SIZE), vy,
+                    INT_TO_FIXED(y), INT_TO_FIXED(height), &entry_y, &exit_y))
+    {
+        return -1;
+    }
+    
+    // The boxes touch once both axes overlap, and stop once either doesn't
+    int entry = (entry_x > entry_y) ? entry_x : entry_y;
+    int exit = (exit_x < exit_y) ? exit_x : exit_y;
+    if (entry >= exit || entry > SWEEP_FULL)
+    {
+        return -1;
+    }
+    
+    // The axis that started overlapping last is the face that was hit
+    *axis = (entry_x > entry_y) ? AXIS_X : AXIS_Y;
+    
+    if (entry < 0)
+    {
+        // Already overlapping (e.g. the paddle moved into the ball). Only
+        // count it if the ball is still heading further in.
+        int to_center = (*axis == AXIS_X)
+            ? (x * 2 + width) - (FIXED_TO_INT(ball->x) * 2 + BALL_SIZE)
+            : (y * 2 + height) - (FIXED_TO_INT(ball->y) * 2 + BALL_SIZE);
+        fixed_t vel = (*axis == AXIS_X) ? vx : vy;
+        bool toward = (vel > 0 && to_center > 0) || (vel < 0 && to_center < 0);
+        return toward ? 0 : -1;
+    }
+    
+    return entry;
+}
+
+/*
+ * bounce_ball - Reflect the ball off the side of a rectangle it hit
+ * 
+ * Only the velocity component for the face that was hit changes, and it
+ * is pointed away from the rectangle's center (so a ball that clipped a
+ * brick's side keeps going up instead of being sent back down).
+ */
+static void bounce_ball(ball_t* ball, int axis, int x, int y, int width, int height)
+{
+    if (axis == AXIS_X)
+    {
+        bool left_of = FIXED_TO_INT(ball->x) * 2 + BALL_SIZE < x * 2 + width;
+        fixed_t speed = (ball->dx < 0) ? -ball->dx : ball->dx;
+        ball->dx = left_of ? -speed : speed;
+    }
+    else
+    {
+        bool above = FIXED_TO_INT(ball->y) * 2 + BALL_SIZE < y * 2 + height;
+        fixed_t speed = (ball->dy < 0) ? -ball->dy : ball->dy;
+        ball->dy = above ? -speed : speed;
+    }
+}
+
+/* ============================================================================
+ * BALL GRID (BALL VS BALL)
+ * ============================================================================
+ * Testing every pair of balls is far too slow with hundreds of them. So
+ * after the balls have moved, they are sorted into a uniform grid of
+ * BALL_GRID_CELL pixel cells (a counting sort: a couple of passes over
+ * the balls, rebuilt from scratch every step), and each ball only looks
+ * at the balls in its own and neighbouring cells. Bricks don't need this:
+ * they never move, and already sit on their own grid (brick_cells_in_rect).
+ */
+
+#define BALL_GRID_CELL BALL_SIZE   // Cell size in pixels (at least BALL_SIZE)
+#define BALL_GRID_COLS (VGA_WIDTH / BALL_GRID_CELL)
+#define BALL_GRID_ROWS (VGA_HEIGHT / BALL_GRID_CELL)
+#define BALL_GRID_CELLS (BALL_GRID_COLS * BALL_GRID_ROWS)
+
+static uint16_t grid_start[BALL_GRID_CELLS + 1];  // Where each cell's balls start
+static uint16_t grid_balls[MAX_BALLS];            // Ball slots, sorted by cell
+static uint16_t grid_cell[MAX_BALLS];             // Cell of each ball slot
+
+/*
+ * ball_grid_cell - Grid cell a ball's top-left corner is in
+ */
+static int ball_grid_cell(const ball_t* ball)
+{
+    int col = FIXED_TO_INT(ball->x) / BALL_GRID_CELL;
+    int row = FIXED_TO_INT(ball->y) / BALL_GRID_CELL;
+    
+    if (col < 0) col = 0;
+    if (col > BALL_GRID_COLS - 1) col = BALL_GRID_COLS - 1;
+    if (row < 0) row = 0;
+    if (row > BALL_GRID_ROWS - 1) row = BALL_GRID_ROWS - 1;
+    
+    return row * BALL_GRID_COLS + col;
+}
+
+/*
+ * build_ball_grid - Sort the live balls into the grid
+ * 
+ * Afterwards cell c holds grid_balls[grid_start[c]] up to (not including)
+ * grid_balls[grid_start[c + 1]].
+ */
+static void build_ball_grid()
+{
+    const ball_t* ball;
+    int total = 0;
+    
+    for (int c = 0; c < BALL_GRID_CELLS; c++)
+    {
+        grid_start[c] = 0;
+    }
+    
+    // Count the balls in each cell
+    POOL_FOR_EACH(&game.balls, ball)
     {
-        game.balls[i].active = false;
+        int slot = ball - game.balls.items;
+        grid_cell[slot] = ball_grid_cell(ball);
+        grid_start[grid_cell[slot]]++;
     }
     
-    // Activate first ball in center of screen
-    game.balls[0].active = true;
-    game.balls[0].x = VGA_WIDTH / 2;
-    game.balls[0].y = VGA_HEIGHT / 2;
-    game.balls[0].dx = BALL_SPEED;
-    game.balls[0].dy = -BALL_SPEED;  // Start going upward
-    game.balls[0].trail_index = 0;
+    // Turn the counts into where each cell ends...
+    for (int c = 0; c < BALL_GRID_CELLS; c++)
+    {
+        total += grid_start[c];
+        grid_start[c] = total;
+    }
+    grid_start[BALL_GRID_CELLS] = total;
+    
+    // ...and fill each cell from its end, which leaves it at its start
+    POOL_FOR_EACH(&game.balls, ball)
+    {
+        int slot = ball - game.balls.items;
+        grid_balls[--grid_start[grid_cell[slot]]] = slot;
+    }
+}
+
+/*
+ * collide_ball_pair - Bounce two balls off each other if they overlap
+ * 
+ * The balls are boxes of equal weight, so they just swap their speeds
+ * along the axis they overlap least on (the face that met) - but only if
+ * they're still moving into each other. Speeds only ever change hands,
+ * so no ball ends up stopped or too fast.
+ */
+static void collide_ball_pair(ball_t* a, ball_t* b)
+{
+    fixed_t apart_x = b->x - a->x;
+    fixed_t apart_y = b->y - a->y;
+    fixed_t overlap_x = INT_TO_FIXED(BALL_SIZE) - (apart_x < 0 ? -apart_x : apart_x);
+    fixed_t overlap_y = INT_TO_FIXED(BALL_SIZE) - (apart_y < 0 ? -apart_y : apart_y);
+    
+    PROFILE_COUNT(PROFILE_COUNT_COLLISION_TESTS, 1);
+    
+    if (overlap_x <= 0 || overlap_y <= 0)
+    {
+        return;
+    }
+    
+    if (overlap_x < overlap_y)
+    {
+        if ((apart_x > 0 && b->dx < a->dx) || (apart_x < 0 && b->dx > a->dx))
+        {
+            fixed_t dx = a->dx;
+            a->dx = b->dx;
+            b->dx = dx;
+        }
+    }
+    else if ((apart_y > 0 && b->dy < a->dy) || (apart_y < 0 && b->dy > a->dy))
+    {
+        fixed_t dy = a->dy;
+        a->dy = b->dy;
+        b->dy = dy;
+    }
+}
+
+/*
+ * collide_balls - Bounce overlapping balls off each other
+ * 
+ * Balls less than a cell apart are in the same or neighbouring cells. Each
+ * pair is visited once: within a cell, each ball only looks at the ones
+ * after it, and across cells, only the east and three southern neighbours
+ * are looked at (the other four see this cell as their neighbour).
+ */
+static void collide_balls()
+{
+    static const int neighbours[4][2] = { {1, 0}, {-1, 1}, {0, 1}, {1, 1} };
+    
+    build_ball_grid();
+    
+    for (int i = 0; i < grid_start[BALL_GRID_CELLS]; i++)
+    {
+        ball_t* ball = &game.balls.items[grid_balls[i]];
+        int cell = grid_cell[grid_balls[i]];
+        int col = cell % BALL_GRID_COLS;
+        int row = cell / BALL_GRID_COLS;
+        
+        // The rest of this cell
+        for (int j = i + 1; j < grid_start[cell + 1]; j++)
+        {
+            collide_ball_pair(ball, &game.balls.items[grid_balls[j]]);
+        }
+        
+        for (int n = 0; n < 4; n++)
+        {
+            int next_col = col + neighbours[n][0];
+            int next_row = row + neighbours[n][1];
+            if (next_col < 0 || next_col >= BALL_GRID_COLS || next_row >= BALL_GRID_ROWS)
+            {
+                continue;
+            }
+            
+            int next = next_row * BALL_GRID_COLS + next_col;
+            for (int j = grid_start[next]; j < grid_start[next + 1]; j++)
+            {
+                collide_ball_pair(ball, &game.balls.items[grid_balls[j]]);
+            }
+        }
+    }
 }
 
 /*
  * update_balls - Update all ball physics
  * 
  * This is the heart of the game! It handles:
- * - Ball movement
+ * - Ball movement (in fixed point, scaled by the speed power-ups)
  * - Wall collisions
  * - Paddle collisions (with "english" - spin based on hit location)
  * - Brick collisions
  * - Losing a life when ball falls off bottom
  * 
- * Called every frame.
+ * Each step's motion is swept against everything in its path. At the
+ * first contact the ball moves up to it, bounces, and carries on with the
+ * rest of the step's motion. Only the bricks in the grid cells under the
+ * swept box are tested, and walls and paddle only when the box reaches
+ * them. Once every ball has moved, balls that overlap bounce off each
+ * other (when game.ball_collisions is on).
+ * 
+ * Called every simulation step.
  */
 void update_balls()
 {
-    bool any_active = false;  // Track if any ball is still in play
+    bool any_active = (game.balls.count > 0);  // Is any ball still in play?
     player_t* player = &game.players[game.current_player];
     
-    for (int i = 0; i < MAX_BALLS; i++)
+    // Walls are boxes just outside the screen (the bottom stays open)
+    static const int walls[3][4] = {
+        {-64, -64, 64, VGA_HEIGHT + 128},           // Left
+        {VGA_WIDTH, -64, 64, VGA_HEIGHT + 128},     // Right
+        {-64, -64, VGA_WIDTH + 128, 64}             // Top
+    };
+    
+    // Motion trails get a new point once per tick, so their length
+    // doesn't depend on the step rate
+    bool trail_tick = (game.sim_steps % SIM_SUBSTEPS == 0);
+    if (trail_tick)
     {
-        // Skip inactive balls
-        if (!game.balls[i].active)
+        game.trail_head = (game.trail_head + 1) & (BALL_TRAIL_LENGTH - 1);
+    }
+    
+    ball_t* ball;
+    POOL_FOR_EACH(&game.balls, ball)
+    {
+        if (trail_tick)
         {
-            continue;
+            game.ball_trails[ball - game.balls.items][game.trail_head] = trail_point(ball);
         }
         
-        any_active = true;
-        
-        // Update motion trail (circular buffer of last 10 positions)
-        game.balls[i].trail_x[game.balls[i].trail_index] = game.balls[i].x;
-        game.balls[i].trail_y[game.balls[i].trail_index] = game.balls[i].y;
-        game.balls[i].trail_index = (game.balls[i].trail_index + 1) % 10;
-        
-        // Calculate speed (can be modified by power-ups)
-        int speed_x = game.balls[i].dx;
-        int speed_y = game.balls[i].dy;
-        
-        // Handle slow-motion power-up (skip every other frame)
+        // This step's share of a tick's motion. Slow ball halves it and fast
+        // ball doubles it (a velocity scale, so slowed balls still move
+        // smoothly every step)
+        fixed_t move_x = ball->dx / SIM_SUBSTEPS;
+        fixed_t move_y = ball->dy / SIM_SUBSTEPS;
         if (game.ball_speed_multiplier < 0)
         {
-            static int slow_counter = 0;
-            slow_counter++;
-            if (slow_counter % 2 == 0)
-            {
-                continue;  // Skip this frame
-            }
+            move_x /= 2;
+            move_y /= 2;
         }
-        // Handle fast power-up (double speed)
         else if (game.ball_speed_multiplier > 0)
         {
-            speed_x *= 2;
-            speed_y *= 2;
-        }
-        
-        // Move ball
-        game.balls[i].x += speed_x;
-        game.balls[i].y += speed_y;
-        
-        // ====================================================================
-        // COLLISION: Left and right walls
-        // ====================================================================
-        if (game.balls[i].x <= 0 || game.balls[i].x >= VGA_WIDTH - BALL_SIZE)
-        {
-            game.balls[i].dx = -game.balls[i].dx;  // Reverse horizontal direction
-            play_sound(400, 30);
+            move_x *= 2;
+            move_y *= 2;
         }
         
-        // ====================================================================
-        // COLLISION: Top wall
-        // ====================================================================
-        if (game.balls[i].y <= 0)
+        for (int hits = 0; hits <= BALL_MAX_HITS; hits++)
         {
-            game.balls[i].dy = -game.balls[i].dy;  // Reverse vertical direction
-            play_sound(400, 30);
-        }
-        
-        // ====================================================================
-        // COLLISION: Bottom (ball fell off = lose life)
-        // ====================================================================
-        if (game.balls[i].y >= VGA_HEIGHT)
-        {
-            game.balls[i].active = false;
-            continue;  // Don't process rest of this ball
-        }
-        
-        // ====================================================================
-        // COLLISION: Paddle
-        // ====================================================================
-        if (check_collision(game.balls[i].x, game.balls[i].y, BALL_SIZE, BALL_SIZE,
-                          player->paddle_x, PADDLE_Y, player->paddle_width, PADDLE_HEIGHT))
-        {
-            // Bounce ball upward (always make dy negative)
-            game.balls[i].dy = -abs(game.balls[i].dy);
+            // Find the earliest contact along the remaining motion
+            int best_time = SWEEP_FULL + 1;
+            int best_axis = AXIS_Y;
+            int best_kind = -1;     // 0 = wall, 1 = paddle, 2 = brick
+            int best_row = 0, best_col = 0;
+            int hit_x = 0, hit_y = 0, hit_w = 0, hit_h = 0;
+            int axis, time;
+            
+            // Box covering the ball over the whole remaining motion. Most
+            // balls are nowhere near a wall or the paddle, and nothing
+            // outside this box needs sweeping.
+            fixed_t sweep_x = (move_x < 0) ? ball->x + move_x : ball->x;
+            fixed_t sweep_y = (move_y < 0) ? ball->y + move_y : ball->y;
+            int sweep_left = FIXED_TO_INT(sweep_x);
+            int sweep_top = FIXED_TO_INT(sweep_y);
+            int sweep_right = FIXED_TO_INT(sweep_x + (move_x < 0 ? -move_x : move_x)) + BALL_SIZE;
+            int sweep_bottom = FIXED_TO_INT(sweep_y + (move_y < 0 ? -move_y : move_y)) + BALL_SIZE;
             
-            // Add "english" - change horizontal direction based on where ball hit
-            // This gives player more control!
-            int paddle_center = player->paddle_x + player->paddle_width / 2;
-            int ball_center = game.balls[i].x + BALL_SIZE / 2;
-            int offset = ball_center - paddle_center;
+            // ================================================================
+            // SWEEP: Left, right and top walls
+            // ================================================================
+            bool near_wall[3] = {
+                sweep_left <= 0, sweep_right >= VGA_WIDTH - 1, sweep_top <= 0
+            };
             
-            if (offset < -10)
+            for (int w = 0; w < 3; w++)
             {
-                game.balls[i].dx = -BALL_SPEED;  // Hit left side = go left
+                if (!near_wall[w])
+                {
+                    continue;
+                }
+                
+                time = sweep_ball(ball, move_x, move_y,
+                                  walls[w][0], walls[w][1], walls[w][2], walls[w][3], &axis);
+                if (time >= 0 && time < best_time)
+                {
+                    best_time = time;
+                    best_axis = axis;
+                    best_kind = 0;
+                    hit_x = walls[w][0]; hit_y = walls[w][1];
+                    hit_w = walls[w][2]; hit_h = walls[w][3];
+                }
             }
-            else if (offset > 10)
+            
+            // ================================================================
+            // SWEEP: Paddle
+            // ================================================================
+            if (sweep_bottom >= PADDLE_Y - 1 && sweep_top <= PADDLE_Y + PADDLE_HEIGHT)
             {
-                game.balls[i].dx = BALL_SPEED;   // Hit right side = go right
+                time = sweep_ball(ball, move_x, move_y,
+                                  player->paddle_x, PADDLE_Y, player->paddle_width, PADDLE_HEIGHT, &axis);
+                if (time >= 0 && time < best_time)
+                {
+                    best_time = time;
+                    best_axis = axis;
+                    best_kind = 1;
+                    hit_x = player->paddle_x; hit_y = PADDLE_Y;
+                    hit_w = player->paddle_width; hit_h = PADDLE_HEIGHT;
+                }
             }
-            // If hit center, keep current direction
             
-            play_sound(600, 30);
+            // ================================================================
+            // SWEEP: Bricks
+            // ================================================================
+            // Only the bricks in the grid cells under the box
+            int row_first, row_last, col_first, col_last;
             
-            // Spawn sparkle particles on paddle hit
-            spawn_particle(game.balls[i].x, game.balls[i].y, 0, -2, 15, 10);
-            spawn_particle(game.balls[i].x, game.balls[i].y, 1, -2, 14, 10);
-            spawn_particle(game.balls[i].x, game.balls[i].y, -1, -2, 14, 10);
-        }
-        
-        // ====================================================================
-        // COLLISION: Bricks
-        // ====================================================================
-        for (int row = 0; row < BRICK_ROWS; row++)
-        {
-            for (int col = 0; col < BRICK_COLS; col++)
+            if (!brick_cells_in_rect(sweep_left, sweep_top,
+                                     sweep_right - sweep_left + 1, sweep_bottom - sweep_top + 1,
+                                     &row_first, &row_last, &col_first, &col_last))
             {
-                // Skip destroyed bricks
-                if (game.bricks[row][col].health == 0)
-                {
-                    continue;
-                }
-                
-                // Calculate brick position
-                int brick_x = col * (BRICK_WIDTH + 2) + 5;
-                int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_START_Y;
-                
-                // Check collision
-                if (check_collision(game.balls[i].x, game.balls[i].y, BALL_SIZE, BALL_SIZE,
-                                  brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT))
+                row_first = 0;
+                row_last = -1;   // Nothing to test
+            }
+            
+            for (int row = row_first; row <= row_last; row++)
+            {
+                for (int word = col_first / BRICK_WORD_BITS; word <= col_last / BRICK_WORD_BITS; word++)
                 {
-                    // Hit a brick! Damage it
-                    game.bricks[row][col].health--;
-                    
-                    // Bounce ball
-                    game.balls[i].dy = -game.balls[i].dy;
+                    // Only the standing bricks in range
+                    uint32_t bits = brick_live_bits(row, word, col_first, col_last);
                     
-                    // Check if brick was destroyed
-                    if (game.bricks[row][col].health == 0)
+                    while (bits != 0)
                     {
-                        // Award points
-                        player->score += 10;
+                        int col = word * BRICK_WORD_BITS + BRICK_BIT_SCAN(bits);
+                        bits &= bits - 1;
                         
-                        // Visual feedback
-                        spawn_explosion(brick_x + BRICK_WIDTH/2, brick_y + BRICK_HEIGHT/2,
-                                      levels[game.level].colors[row]);
+                        // Calculate brick position
+                        int brick_x = BRICK_X(col);
+                        int brick_y = BRICK_Y(row);
                         
-                        // Maybe spawn a power-up
-                        spawn_powerup(brick_x, brick_y);
-                        
-                        // Screen shake for impact feel
-                        game.screen_shake_timer = 3;
+                        time = sweep_ball(ball, move_x, move_y,
+                                          brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT, &axis);
+                        if (time >= 0 && time < best_time)
+                        {
+                            best_time = time;
+                            best_axis = axis;
+                            best_kind = 2;
+                            best_row = row;
+                            best_col = col;
+                            hit_x = brick_x; hit_y = brick_y;
+                            hit_w = BRICK_WIDTH; hit_h = BRICK_HEIGHT;
+                        }
                     }
-                    else
+                }
+            }
+            
+            // Nothing in the way - finish the motion
+            if (best_kind < 0)
+            {
+                ball->x += move_x;
+                ball->y += move_y;
+                break;
+            }
+            
+            // Still bouncing around after several hits (wedged in a corner)?
+            // Stop at the contact point rather than risk passing through
+            if (hits == BALL_MAX_HITS)
+            {
+                ball->x += move_x * best_time / SWEEP_FULL;
+                ball->y += move_y * best_time / SWEEP_FULL;
+                break;
+            }
+            
+            // Move up to the contact point and use up that part of the motion
+            ball->x += move_x * best_time / SWEEP_FULL;
+            ball->y += move_y * best_time / SWEEP_FULL;
+            move_x -= move_x * best_time / SWEEP_FULL;
+            move_y -= move_y * best_time / SWEEP_FULL;
+            
+            // Bounce the rest of the motion along with the velocity
+            fixed_t old_dx = ball->dx, old_dy = ball->dy;
+            bounce_ball(ball, best_axis, hit_x, hit_y, hit_w, hit_h);
+            if (ball->dx != old_dx) move_x = -move_x;
+            if (ball->dy != old_dy) move_y = -move_y;
+            
+            if (best_kind == 0)
+            {
+                events_push(EVENT_WALL_HIT, FIXED_TO_INT(ball->x), FIXED_TO_INT(ball->y));
+            }
+            else if (best_kind == 1)
+            {
+                // Add "english" when the top of the paddle was hit - change
+                // horizontal direction based on where the ball hit
+                // This gives player more control!
+                if (best_axis == AXIS_Y && ball->dy < 0)
+                {
+                    int paddle_center = player->paddle_x + player->paddle_width / 2;
+                    int ball_center = FIXED_TO_INT(ball->x) + BALL_SIZE / 2;
+                    int offset = ball_center - paddle_center;
+                    
+                    if (offset < -10)
                     {
-                        // Brick damaged but not destroyed - make it shake
-                        game.bricks[row][col].shake_timer = 5;
-                        play_sound(300, 30);
+                        ball->dx = INT_TO_FIXED(-BALL_SPEED);  // Hit left side = go left
                     }
+                    else if (offset > 10)
+                    {
+                        ball->dx = INT_TO_FIXED(BALL_SPEED);   // Hit right side = go right
+                    }
+                    // If hit center, keep current direction
                     
-                    // Only process one brick collision per frame
-                    // (prevents ball from hitting multiple bricks at once)
-                    goto next_ball;
+                    // The rest of this step follows the new direction
+                    if ((ball->dx < 0) != (move_x < 0))
+                    {
+                        move_x = -move_x;
+                    }
+                }
+                
+                // Sound and sparkles where it hit
+                events_push(EVENT_PADDLE_HIT, FIXED_TO_INT(ball->x), FIXED_TO_INT(ball->y));
+            }
+            else
+            {
+                // Hit a brick! Damage it
+                brick_t* brick = &game.bricks[best_row][best_col];
+                brick->health--;
+                mark_brick_dirty(best_row, best_col);
+                
+                // Check if brick was destroyed (points, power-up drop and
+                // explosion follow once the step is done)
+                if (brick->health == 0)
+                {
+                    brick_destroyed(best_row, best_col);
+                    events_push_brick(EVENT_BRICK_DESTROYED, best_row, best_col);
+                }
+                else
+                {
+                    // Brick damaged but not destroyed - it will shake
+                    events_push_brick(EVENT_BRICK_DAMAGED, best_row, best_col);
                 }
             }
         }
         
-        next_ball:;  // Label for breaking out of nested loops
+        // ====================================================================
+        // COLLISION: Bottom (ball fell off = lose life)
+        // ====================================================================
+        if (FIXED_TO_INT(ball->y) >= VGA_HEIGHT)
+        {
+            if (game.mode == GAME_MODE_STORM)
+            {
+                // The storm never dies down: the ball is served again from
+                // the paddle, right above where it fell
+                int serve_x = FIXED_TO_INT(ball->x);
+                if (serve_x < player->paddle_x)
+                {
+                    serve_x = player->paddle_x;
+                }
+                if (serve_x > player->paddle_x + player->paddle_width - BALL_SIZE)
+                {
+                    serve_x = player->paddle_x + player->paddle_width - BALL_SIZE;
+                }
+                
+                ball->x = INT_TO_FIXED(serve_x);
+                ball->y = INT_TO_FIXED(PADDLE_Y - BALL_SIZE - 1);
+                ball->dy = INT_TO_FIXED(-BALL_SPEED);
+                ball->prev_x = ball->x;
+                ball->prev_y = ball->y;
+                ball_trail_reset(ball);
+            }
+            else
+            {
+                ball_pool_free(&game.balls, ball);
+            }
+        }
+    }
+    
+    // ========================================================================
+    // COLLISION: Balls against each other (if turned on)
+    // ========================================================================
+    if (game.ball_collisions && game.balls.count > 1)
+    {
+        collide_balls();
     }
     
     // ========================================================================
@@ -327,6 +938,7 @@ void update_balls()
     if (!any_active)
     {
         player->lives--;
+        events_push(EVENT_LIFE_LOST, 0, 0);
         
         // If player still has lives, spawn a new ball
         if (player->lives > 0)
@@ -0,0 +1,122 @@
+#ifndef BREAKOUT_POOL_H
+#define BREAKOUT_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Fixed-size object pools with O(1) spawn and free.
+ *
+ * POOL_DEFINE(name, type, capacity) makes a pool type name_t holding
+ * `capacity` objects (at most 65534) plus name_init, name_spawn, name_clone,
+ * name_full and name_free.
+ * The storage is a plain array inside the pool, so pools live wherever
+ * their owner does (here: inside game_state_t) - nothing is allocated.
+ *
+ * Objects stay in their slot while alive, so pointers and slot numbers
+ * stay valid. The object type provides two fields for the pool:
+ *   bool active;        // Set while the object is alive
+ *   uint16_t pool_link; // Free: next free slot. Alive: index into live[].
+ * Free slots are chained through pool_link (the free list), and the slots
+ * of live objects are kept packed in live[], so POOL_FOR_EACH only visits
+ * live objects.
+ *
+ * Each pool also counts its high-water mark (most objects alive at once)
+ * and the spawns it had to refuse because it was full. Emptying a pool
+ * doesn't reset them; they start at 0 with the zeroed game state.
+ */
+
+#define POOL_END 0xFFFF    // End of the free list
+
+#define POOL_DEFINE(name, type, capacity)                                   \
+    typedef struct {                                                        \
+        type items[capacity];                                               \
+        uint16_t live[capacity];    /* Slots of the live objects, packed */ \
+        uint16_t count;             /* Live objects */                      \
+        uint16_t free_head;         /* First free slot (POOL_END = full) */ \
+        uint16_t high_water;        /* Most objects alive at once */        \
+        uint16_t spawn_failures;    /* Spawns refused while full */         \
+    } name##_t;                                                             \
+                                                                            \
+    _Static_assert((capacity) < POOL_END, #name " is too large");           \
+                                                                            \
+    /* Empty the pool (the counters keep counting) */                       \
+    static inline void name##_init(name##_t* pool)                          \
+    {                                                                       \
+        for (int i = 0; i < (capacity); i++)                                \
+        {                                                                   \
+            pool->items[i].active = false;                                  \
+            pool->items[i].pool_link = (i + 1 < (capacity)) ? i + 1 : POOL_END; \
+        }                                                                   \
+        pool->count = 0;                                                    \
+        pool->free_head = 0;                                                \
+    }                                                                       \
+                                                                            \
+    /* Take a free object (0 if the pool is full); its fields are stale */  \
+    static inline type* name##_spawn(name##_t* pool)                        \
+    {                                                                       \
+        uint16_t slot = pool->free_head;                                    \
+        if (slot == POOL_END)                                               \
+        {                                                                   \
+            pool->spawn_failures++;                                         \
+            return 0;                                                       \
+        }                                                                   \
+                                                                            \
+        type* item = &pool->items[slot];                                    \
+        pool->free_head = item->pool_link;                                  \
+        item->pool_link = pool->count;                                      \
+        item->active = true;                                                \
+        pool->live[pool->count++] = slot;                                   \
+        if (pool->count > pool->high_water)                                 \
+        {                                                                   \
+            pool->high_water = pool->count;                                 \
+        }                                                                   \
+        return item;                                                        \
+    }                                                                       \
+                                                                            \
+    /* Spawn a copy of a live object (0 if the pool is full) */            \
+    static inline type* name##_clone(name##_t* pool, const type* from)      \
+    {                                                                       \
+        type* item = name##_spawn(pool);                                    \
+        if (item)                                                           \
+        {                                                                   \
+            uint16_t link = item->pool_link;                                \
+            *item = *from;                                                  \
+            item->pool_link = link;                                         \
+        }                                                                   \
+        return item;                                                        \
+    }                                                                       \
+                                                                            \
+    static inline bool name##_full(const name##_t* pool)                    \
+    {                                                                       \
+        return pool->free_head == POOL_END;                                 \
+    }                                                                       \
+                                                                            \
+    /* Give an object back: the last live slot takes its place in live[] */ \
+    static inline void name##_free(name##_t* pool, type* item)              \
+    {                                                                       \
+        uint16_t slot = (uint16_t)(item - pool->items);                     \
+        uint16_t last = pool->live[--pool->count];                          \
+                                                                            \
+        pool->live[item->pool_link] = last;                                 \
+        pool->items[last].pool_link = item->pool_link;                      \
+                                                                            \
+        item->active = false;                                               \
+        item->pool_link = pool->free_head;                                  \
+        pool->free_head = slot;                                             \
+    }
+
+/*
+ * POOL_FOR_EACH - Loop over the live objects (from the end of live[])
+ *
+ * `item` must be a pointer variable of the object type. Freeing the
+ * current object inside the loop is fine (the slot moved into its place
+ * was already visited), freeing any other one is not. Objects spawned
+ * inside the loop are not visited until the next one.
+ */
+#define POOL_FOR_EACH(pool, item)                                           \
+    for (int item##_at = (pool)->count - 1;                                 \
+         item##_at >= 0 && ((item) = &(pool)->items[(pool)->live[item##_at]], true); \
+         item##_at--)
+
+#endif // BREAKOUT_POOL_H
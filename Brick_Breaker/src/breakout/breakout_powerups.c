@@ -17,12 +17,12 @@
 #include "graphics/vga.h"
 #include "timer/timer.h"
 #include "breakout.h"
+#include "breakout_events.h"
 
 // External references
 extern game_state_t game;
 extern int random_range(int min, int max);
-extern void spawn_explosion(int x, int y, uint8_t color);
-extern void play_sound(int frequency, int duration_ms);
+extern void ball_trail_reset(const ball_t* ball);
 
 /*
  * spawn_powerup - Maybe create a power-up at given position
@@ -41,53 +41,47 @@ void spawn_powerup(int x, int y)
         return;  // No power-up this time
     }
     
-    // Look for an empty power-up slot
-    for (int i = 0; i < MAX_POWERUPS; i++)
+    // Take a free power-up slot (a full pool counts the miss)
+    powerup_t* powerup = powerup_pool_spawn(&game.powerups);
+    if (!powerup)
     {
-        if (!game.powerups[i].active)
-        {
-            // Found a slot! Initialize the power-up
-            game.powerups[i].x = x;
-            game.powerups[i].y = y;
-            
-            // Choose random power-up type (skip POWERUP_NONE)
-            game.powerups[i].type = random_range(1, POWERUP_COUNT - 1);
-            game.powerups[i].active = true;
-            
-            // Set color based on power-up type (for visual identification)
-            switch (game.powerups[i].type)
-            {
-                case POWERUP_MULTIBALL:
-                    game.powerups[i].color = 14;  // Yellow
-                    break;
-                case POWERUP_EXPAND_PADDLE:
-                    game.powerups[i].color = 2;   // Green (good!)
-                    break;
-                case POWERUP_SHRINK_PADDLE:
-                    game.powerups[i].color = 4;   // Red (bad!)
-                    break;
-                case POWERUP_LASER:
-                    game.powerups[i].color = 9;   // Light blue
-                    break;
-                case POWERUP_SLOW_BALL:
-                    game.powerups[i].color = 11;  // Cyan
-                    break;
-                case POWERUP_EXTRA_LIFE:
-                    game.powerups[i].color = 13;  // Pink
-                    break;
-                case POWERUP_FAST_BALL:
-                    game.powerups[i].color = 12;  // Light red
-                    break;
-                default:
-                    game.powerups[i].color = 15;  // White (fallback)
-                    break;
-            }
-            
-            return;  // Done!
-        }
+        return;
     }
     
-    // All power-up slots full - oh well, no power-up this time
+    powerup->x = x;
+    powerup->y = y;
+    
+    // Choose random power-up type (skip POWERUP_NONE)
+    powerup->type = random_range(1, POWERUP_COUNT - 1);
+    
+    // Set color based on power-up type (for visual identification)
+    switch (powerup->type)
+    {
+        case POWERUP_MULTIBALL:
+            powerup->color = 14;  // Yellow
+            break;
+        case POWERUP_EXPAND_PADDLE:
+            powerup->color = 2;   // Green (good!)
+            break;
+        case POWERUP_SHRINK_PADDLE:
+            powerup->color = 4;   // Red (bad!)
+            break;
+        case POWERUP_LASER:
+            powerup->color = 9;   // Light blue
+            break;
+        case POWERUP_SLOW_BALL:
+            powerup->color = 11;  // Cyan
+            break;
+        case POWERUP_EXTRA_LIFE:
+            powerup->color = 13;  // Pink
+            break;
+        case POWERUP_FAST_BALL:
+            powerup->color = 12;  // Light red
+            break;
+        default:
+            powerup->color = 15;  // White (fallback)
+            break;
+    }
 }
 
 /*
@@ -105,7 +99,7 @@ static bool check_collision(int x1, int y1, int w1, int h1, int x2, int y2, int
 }
 
 /*
- * update_powerups - Update all active power-ups
+ * update_powerups - Update all falling power-ups
  * 
  * This makes power-ups fall down and checks if the player caught them.
  * Called every frame from the main game loop.
@@ -114,45 +108,43 @@ void update_powerups()
 {
     player_t* player = &game.players[game.current_player];
     
-    for (int i = 0; i < MAX_POWERUPS; i++)
+    powerup_t* powerup;
+    POOL_FOR_EACH(&game.powerups, powerup)
     {
-        // Skip inactive power-ups
-        if (!game.powerups[i].active)
-        {
-            continue;
-        }
-        
         // Make power-up fall
-        game.powerups[i].y += POWERUP_FALL_SPEED;
+        powerup->y += POWERUP_FALL_SPEED;
         
         // Check if paddle caught the power-up
-        if (check_collision(game.powerups[i].x, game.powerups[i].y, 
+        if (check_collision(powerup->x, powerup->y, 
                           POWERUP_SIZE, POWERUP_SIZE,
                           player->paddle_x, PADDLE_Y, 
                           player->paddle_width, PADDLE_HEIGHT))
         {
-            // Power-up caught! Apply the effect
-            switch (game.powerups[i].type)
+            // Power-up caught! Apply the effect (its sound and explosion
+            // follow once the step is done)
+            switch (powerup->type)
             {
                 case POWERUP_MULTIBALL:
-                    // Activate additional balls
-                    for (int b = 1; b < MAX_BALLS; b++)
+                    // Add copies of a ball in play, up to MULTIBALL_BALLS
+                    // (in a ball storm, until the pool is full)
+                    if (game.balls.count > 0)
                     {
-                        if (!game.balls[b].active)
+                        const ball_t* source = &game.balls.items[game.balls.live[0]];
+                        int limit = (game.mode == GAME_MODE_STORM) ? MAX_BALLS : MULTIBALL_BALLS;
+                        
+                        while (game.balls.count < limit && !ball_pool_full(&game.balls))
                         {
-                            // Copy first ball's state
-                            game.balls[b] = game.balls[0];
-                            game.balls[b].active = true;
+                            ball_t* ball = ball_pool_clone(&game.balls, source);
+                            ball_trail_reset(ball);
                             
                             // Give it a random horizontal direction
-                            game.balls[b].dx = random_range(-3, 3);
-                            if (game.balls[b].dx == 0)
+                            ball->dx = INT_TO_FIXED(random_range(-3, 3));
+                            if (ball->dx == 0)
                             {
-                                game.balls[b].dx = 2;  // Make sure it moves
+                                ball->dx = INT_TO_FIXED(2);  // Make sure it moves
                             }
                         }
                     }
-                    play_sound(800, 100);  // High pitch for multi-ball
                     break;
                     
                 case POWERUP_EXPAND_PADDLE:
@@ -162,7 +154,6 @@ void update_powerups()
                     {
                         player->paddle_width = 80;  // Cap maximum size
                     }
-                    play_sound(600, 100);
                     break;
                     
                 case POWERUP_SHRINK_PADDLE:
@@ -172,47 +163,39 @@ void update_powerups()
                     {
                         player->paddle_width = 20;  // Minimum size
                     }
-                    play_sound(400, 100);  // Lower pitch for bad power-up
                     break;
                     
                 case POWERUP_LASER:
                     // Enable laser shooting
                     player->has_laser = true;
-                    play_sound(1000, 100);
                     break;
                     
                 case POWERUP_SLOW_BALL:
                     // Slow down the ball (makes game easier)
                     game.ball_speed_multiplier = -1;
-                    play_sound(300, 100);
                     break;
                     
                 case POWERUP_FAST_BALL:
                     // Speed up the ball (makes game harder)
                     game.ball_speed_multiplier = 1;
-                    play_sound(900, 100);
                     break;
                     
                 case POWERUP_EXTRA_LIFE:
                     // Give player an extra life!
                     player->lives++;
-                    play_sound(1200, 100);  // High pitch for good power-up
                     break;
                     
                 default:
                     break;
             }
             
-            // Deactivate the power-up and show explosion effect
-            game.powerups[i].active = false;
-            spawn_explosion(game.powerups[i].x, game.powerups[i].y, 
-                          game.powerups[i].color);
+            events_push_powerup(powerup);
+            powerup_pool_free(&game.powerups, powerup);
         }
-        
-        // Remove power-up if it fell off the bottom of the screen
-        if (game.powerups[i].y > VGA_HEIGHT)
+        else if (powerup->y > VGA_HEIGHT)
         {
-            game.powerups[i].active = false;
+            // Fell off the bottom of the screen
+            powerup_pool_free(&game.powerups, powerup);
         }
     }
 }
\ No newline at end of file
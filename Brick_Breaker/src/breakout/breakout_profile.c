@@ -0,0 +1,353 @@
+/*
+ * breakout_profile.c - Per-stage frame-time profiler
+ *
+ * Each stage of the update/render pipeline is wrapped in PROFILE(), which
+ * reads the CPU timestamp counter (RDTSC) before and after the call. The
+ * cycles are summed per frame, converted to microseconds and stored in a
+ * ring buffer holding the last PROFILE_HISTORY frames. From that we get
+ * min/avg/max/p99 per stage, shown as a bar graph on top of the HUD (F3).
+ *
+ * Without -DBREAKOUT_PROFILE this whole file compiles to nothing.
+ */
+
+#include "breakout_profile.h"
+
+#ifdef BREAKOUT_PROFILE
+
+#include "graphics/vga.h"
+#include "timer/timer.h"
+#include "sound/pcm.h"
+#include "breakout_text.h"
+
+/* ============================================================================
+ * SAMPLE STORAGE
+ * ============================================================================
+ */
+
+// Cycles spent in each stage during the current frame
+static uint32_t frame_cycles[PROFILE_STAGE_COUNT];
+
+// Last PROFILE_HISTORY frames, in microseconds
+static uint32_t history[PROFILE_HISTORY][PROFILE_STAGE_COUNT];
+static int history_next = 0;
+static int history_count = 0;
+
+// Event counts for the current frame and the same history of frames
+static uint32_t frame_counts[PROFILE_COUNTER_COUNT];
+static uint32_t count_history[PROFILE_HISTORY][PROFILE_COUNTER_COUNT];
+
+// Stats are recomputed every few frames, not on every overlay draw
+#define STATS_INTERVAL 16
+static profile_stats_t stats[PROFILE_STAGE_COUNT];
+static int frames_since_stats = 0;
+
+// TSC rate, measured against the 1 ms PIT tick. A window ends at the first
+// frame after CALIBRATE_MS, which can be much later when frames stall (level
+// start, countdown, turn screens). Past about 1 s the 32-bit cycle delta
+// wraps on a 4 GHz CPU, so a window longer than CALIBRATE_MAX_MS is thrown
+// away and measuring starts over.
+#define CALIBRATE_MS 250
+#define CALIBRATE_MAX_MS (2 * CALIBRATE_MS)
+static uint32_t cycles_per_us = 0;
+static uint32_t calibrate_tsc = 0;
+static uint32_t calibrate_ticks = 0;
+static bool calibrating = false;
+
+/*
+ * profile_add - Charge cycles to a stage for the current frame
+ */
+void profile_add(profile_stage_t stage, uint32_t cycles)
+{
+    frame_cycles[stage] += cycles;
+}
+
+/*
+ * profile_count - Add to one of this frame's event counters
+ */
+void profile_count(profile_counter_t counter, uint32_t amount)
+{
+    frame_counts[counter] += amount;
+}
+
+/*
+ * calibrate - Keep the cycles-per-microsecond estimate up to date
+ */
+static void calibrate()
+{
+    uint32_t now_ticks = timer_get_ticks();
+    uint32_t now_tsc = profile_timestamp();
+
+    if (!calibrating)
+    {
+        calibrate_ticks = now_ticks;
+        calibrate_tsc = now_tsc;
+        calibrating = true;
+        return;
+    }
+
+    uint32_t elapsed_ms = now_ticks - calibrate_ticks;
+    if (elapsed_ms < CALIBRATE_MS)
+    {
+        return;
+    }
+
+    // Too long to trust: keep the old estimate and start a new window
+    if (elapsed_ms > CALIBRATE_MAX_MS)
+    {
+        calibrate_ticks = now_ticks;
+        calibrate_tsc = now_tsc;
+        return;
+    }
+
+    cycles_per_us = (now_tsc - calibrate_tsc) / (elapsed_ms * 1000);
+    if (cycles_per_us == 0)
+    {
+        cycles_per_us = 1;
+    }
+
+    calibrate_ticks = now_ticks;
+    calibrate_tsc = now_tsc;
+}
+
+/* ============================================================================
+ * STATISTICS
+ * ============================================================================
+ */
+
+/*
+ * compute_stats - Recompute min/avg/max/p99 for every stage
+ */
+static void compute_stats()
+{
+    uint32_t sorted[PROFILE_HISTORY];
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        uint32_t sum = 0;
+
+        // Insertion sort - at most 128 small values
+        for (int i = 0; i < history_count; i++)
+        {
+            uint32_t value = history[i][stage];
+            int j = i;
+
+            sum += value;
+            while (j > 0 && sorted[j - 1] > value)
+            {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = value;
+        }
+
+        stats[stage].min = sorted[0];
+        stats[stage].max = sorted[history_count - 1];
+        stats[stage].avg = sum / history_count;
+        stats[stage].p99 = sorted[(history_count * 99 + 99) / 100 - 1];
+    }
+}
+
+/*
+ * profile_end_frame - Store this frame's stage times and start a new frame
+ */
+void profile_end_frame()
+{
+    uint32_t pcm_max;
+
+    calibrate();
+
+    // Average cost of a sample interrupt this frame (0 unless PCM is on)
+    pcm_take_isr_cycles(&frame_counts[PROFILE_COUNT_PCM_CYCLES], &pcm_max);
+
+    // Until the TSC rate is known there is nothing meaningful to store
+    if (cycles_per_us != 0)
+    {
+        for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+        {
+            history[history_next][stage] = frame_cycles[stage] / cycles_per_us;
+        }
+
+        for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+        {
+            count_history[history_next][counter] = frame_counts[counter];
+        }
+
+        history_next = (history_next + 1) & (PROFILE_HISTORY - 1);
+        if (history_count < PROFILE_HISTORY)
+        {
+            history_count++;
+        }
+
+        if (++frames_since_stats >= STATS_INTERVAL)
+        {
+            frames_since_stats = 0;
+            compute_stats();
+        }
+    }
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        frame_cycles[stage] = 0;
+    }
+
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        frame_counts[counter] = 0;
+    }
+}
+
+/*
+ * profile_get_stats - Latest statistics for one stage (all 0 until measured)
+ */
+void profile_get_stats(profile_stage_t stage, profile_stats_t* out)
+{
+    *out = stats[stage];
+}
+
+/*
+ * profile_get_counter - Average and peak per-frame count over the history
+ */
+void profile_get_counter(profile_counter_t counter, uint32_t* avg, uint32_t* max)
+{
+    uint32_t sum = 0;
+
+    *avg = 0;
+    *max = 0;
+
+    for (int i = 0; i < history_count; i++)
+    {
+        uint32_t value = count_history[i][counter];
+
+        sum += value;
+        if (value > *max)
+        {
+            *max = value;
+        }
+    }
+
+    if (history_count > 0)
+    {
+        *avg = sum / history_count;
+    }
+}
+
+/* ============================================================================
+ * OVERLAY
+ * ============================================================================
+ * One row per stage: a bar for the average time, a yellow tick at p99 and
+ * a white tick at the max, plus the average in microseconds. The full bar
+ * width is one 60 Hz frame (16667 us). Below that, one row per counter with
+ * its average (white) and peak (yellow) per frame.
+ */
+
+#define OVERLAY_X       (VGA_WIDTH - 122)
+#define OVERLAY_Y       22
+#define OVERLAY_WIDTH   120
+#define OVERLAY_ROW     8
+#define OVERLAY_ROWS    (PROFILE_STAGE_COUNT + PROFILE_COUNTER_COUNT)
+#define OVERLAY_HEIGHT  (OVERLAY_ROWS * OVERLAY_ROW + 4)
+#define BAR_WIDTH       80
+#define FRAME_BUDGET_US 16667
+
+// Bar color per stage (greens = update, blues/purples = draw)
+static const uint8_t stage_colors[PROFILE_STAGE_COUNT] = {
+    10, 2, 10, 2, 10,           // update_*
+    14,                         // events
+    4, 9, 11, 9, 11, 9, 13      // draw_*
+};
+
+// Marker color per counter
+static const uint8_t counter_colors[PROFILE_COUNTER_COUNT] = {
+    12,                         // collision tests
+    5                           // PCM interrupt cycles
+};
+
+static bool overlay_visible = false;
+static bool overlay_changed = false;
+
+void profile_toggle_overlay()
+{
+    overlay_visible = !overlay_visible;
+    overlay_changed = true;
+}
+
+bool profile_overlay_visible()
+{
+    return overlay_visible;
+}
+
+bool profile_overlay_changed()
+{
+    bool changed = overlay_changed;
+    overlay_changed = false;
+    return changed;
+}
+
+void profile_overlay_rect(int* x, int* y, int* width, int* height)
+{
+    *x = OVERLAY_X;
+    *y = OVERLAY_Y;
+    *width = OVERLAY_WIDTH;
+    *height = OVERLAY_HEIGHT;
+}
+
+/*
+ * bar_length - Scale microseconds to overlay pixels
+ */
+static int bar_length(uint32_t us)
+{
+    if (us >= FRAME_BUDGET_US)
+    {
+        return BAR_WIDTH;
+    }
+
+    return (int)(us * BAR_WIDTH / FRAME_BUDGET_US);
+}
+
+/*
+ * profile_draw_overlay - Draw the bar graph (called from draw_hud)
+ */
+void profile_draw_overlay()
+{
+    if (!overlay_visible)
+    {
+        return;
+    }
+
+    vga_fill_rect(OVERLAY_X, OVERLAY_Y, OVERLAY_WIDTH, OVERLAY_HEIGHT, 0);
+    vga_draw_border(OVERLAY_X, OVERLAY_Y, OVERLAY_WIDTH, OVERLAY_HEIGHT, 8);
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+    {
+        int x = OVERLAY_X + 2;
+        int y = OVERLAY_Y + 2 + stage * OVERLAY_ROW;
+        const profile_stats_t* s = &stats[stage];
+
+        int avg = bar_length(s->avg);
+        if (avg == 0 && s->avg > 0)
+        {
+            avg = 1;  // Keep cheap-but-nonzero stages visible
+        }
+
+        vga_fill_rect(x, y + 1, avg, OVERLAY_ROW - 3, stage_colors[stage]);
+        vga_draw_vline(x + bar_length(s->p99), y, OVERLAY_ROW - 1, 14);
+        vga_draw_vline(x + bar_length(s->max), y, OVERLAY_ROW - 1, 15);
+
+        text_draw_number(OVERLAY_X + OVERLAY_WIDTH - 8, y, (int)s->avg, stage_colors[stage]);
+    }
+
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        int x = OVERLAY_X + 2;
+        int y = OVERLAY_Y + 2 + (PROFILE_STAGE_COUNT + counter) * OVERLAY_ROW;
+        uint32_t avg, max;
+
+        profile_get_counter((profile_counter_t)counter, &avg, &max);
+
+        vga_fill_rect(x, y + 1, 4, OVERLAY_ROW - 3, counter_colors[counter]);
+        text_draw_number(x + 40, y, (int)avg, 15);
+        text_draw_number(OVERLAY_X + OVERLAY_WIDTH - 8, y, (int)max, 14);
+    }
+}
+
+#endif // BREAKOUT_PROFILE
@@ -0,0 +1,90 @@
+#ifndef BREAKOUT_PROFILE_H
+#define BREAKOUT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Frame-time profiler. Only built with -DBREAKOUT_PROFILE (make PROFILE=1);
+ * otherwise PROFILE() just makes the call and everything else disappears.
+ */
+
+// Pipeline stages that get timed
+typedef enum {
+    PROFILE_UPDATE_BALLS = 0,
+    PROFILE_UPDATE_BRICKS,
+    PROFILE_UPDATE_POWERUPS,
+    PROFILE_UPDATE_PARTICLES,
+    PROFILE_UPDATE_LASERS,
+    PROFILE_EVENTS,            // Draining the event queue
+    PROFILE_DRAW_BRICKS,       // Static layer upkeep + compositing
+    PROFILE_DRAW_PADDLE,
+    PROFILE_DRAW_BALLS,
+    PROFILE_DRAW_POWERUPS,
+    PROFILE_DRAW_LASERS,
+    PROFILE_DRAW_PARTICLES,
+    PROFILE_DRAW_HUD,
+    PROFILE_STAGE_COUNT
+} profile_stage_t;
+
+// Per-frame event counts shown next to the stage times
+typedef enum {
+    PROFILE_COUNT_COLLISION_TESTS = 0,   // Ball/laser vs. obstacle tests
+    PROFILE_COUNT_PCM_CYCLES,            // CPU cycles per PCM sample interrupt
+    PROFILE_COUNTER_COUNT
+} profile_counter_t;
+
+#ifdef BREAKOUT_PROFILE
+
+// Frames kept in the ring buffer (power of two)
+#define PROFILE_HISTORY 128
+
+// Per-stage statistics over the ring buffer, in microseconds
+typedef struct {
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+} profile_stats_t;
+
+// Low 32 bits of the CPU timestamp counter (deltas stay valid across wraps)
+static inline uint32_t profile_timestamp()
+{
+    uint32_t low, high;
+    __asm__ volatile ("rdtsc" : "=a"(low), "=d"(high));
+    return low;
+}
+
+// Public functions
+void profile_add(profile_stage_t stage, uint32_t cycles);   // Add to this frame
+void profile_count(profile_counter_t counter, uint32_t amount);
+void profile_get_counter(profile_counter_t counter, uint32_t* avg, uint32_t* max);
+void profile_end_frame();                                  // Push frame into history
+void profile_get_stats(profile_stage_t stage, profile_stats_t* stats);
+void profile_toggle_overlay();
+bool profile_overlay_visible();
+bool profile_overlay_changed();    // Shown or hidden since the last call
+void profile_overlay_rect(int* x, int* y, int* width, int* height);
+void profile_draw_overlay();
+
+// Time one call and charge it to a stage
+#define PROFILE(stage, call)                                        \
+    do {                                                            \
+        uint32_t profile_start = profile_timestamp();               \
+        call;                                                       \
+        profile_add(stage, profile_timestamp() - profile_start);    \
+    } while (0)
+
+#define PROFILE_COUNT(counter, amount) profile_count(counter, amount)
+
+#define PROFILE_FRAME_END() profile_end_frame()
+
+#else
+
+#define PROFILE(stage, call) do { call; } while (0)
+#define PROFILE_COUNT(counter, amount) do { } while (0)
+#define PROFILE_FRAME_END() do { } while (0)
+
+#endif // BREAKOUT_PROFILE
+
+#endif // BREAKOUT_PROFILE_H
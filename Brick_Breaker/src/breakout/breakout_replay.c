@@ -0,0 +1,565 @@
+/*
+ * breakout_replay.c - Input recording and deterministic replay
+ *
+ * The simulation only changes through key events, the random number
+ * generator and the fixed-step clock. So a game can be reproduced exactly
+ * from its seed, player count, starting level and game mode, plus every
+ * key event stamped with the simulation step it was handled at. Screens
+ * that end on a timer (level start, countdown, turn change) are logged
+ * too, so replay never depends on wall-clock time.
+ *
+ * Log layout:
+ *   header  - "BRPL", version, players, level, steps per tick, seed (LE),
+ *             game mode
+ *   entries - steps since the previous entry (7 bits per byte, high bit =
+ *             more bytes follow), then a code byte: bit 7 = pressed, bits
+ *             0-6 = scancode. Code 0x00 marks a screen time-out, 0x80 the
+ *             end of the log.
+ *   trailer - after the end code: steps, checksum, then each player's
+ *             score (4 bytes LE each)
+ *
+ * The ASCII field of key_event_t is not stored - it is a pure function of
+ * the scancode, and the game only looks at scancodes.
+ */
+
+#include <stddef.h>
+#include "graphics/vga.h"
+#include "graphics/palette.h"
+#include "timer/timer.h"
+#include "memory/memory.h"
+#include "breakout_replay.h"
+#include "breakout_text.h"
+
+// External references
+extern game_state_t game;
+extern void init_bricks();
+extern void init_balls();
+extern void random_seed(uint32_t seed);
+extern void stop_sound();
+extern void sound_set_muted(bool muted);
+
+#define REPLAY_VERSION 4
+#define REPLAY_HEADER_SIZE 13
+#define REPLAY_TRAILER_SIZE (8 + 4 * MAX_PLAYERS)
+#define REPLAY_ENTRY_MAX 6         // 5-byte step delta + code
+
+#define REPLAY_CODE_ADVANCE 0x00
+#define REPLAY_CODE_END 0x80
+#define REPLAY_PRESSED 0x80
+
+/* ============================================================================
+ * LOG STORAGE
+ * ============================================================================
+ */
+
+static uint8_t replay_log[REPLAY_MAX_BYTES];
+static uint32_t log_size = 0;        // Bytes recorded or loaded
+static uint32_t log_pos = 0;         // Read position while playing
+static uint32_t last_step = 0;       // Step of the previous entry
+static uint32_t trailer_pos = 0;     // Where the trailer starts (0 = not seen)
+
+static replay_mode_t mode = REPLAY_OFF;
+static bool headless = false;
+static uint32_t play_start_ticks = 0;
+
+// Next entry while playing, decoded ahead of time
+static bool next_valid = false;
+static uint32_t next_step = 0;
+static uint8_t next_code = 0;
+
+static void put_byte(uint8_t value)
+{
+    replay_log[log_size++] = value;
+}
+
+static void put_u32(uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        put_byte((uint8_t)(value >> (i * 8)));
+    }
+}
+
+static uint32_t get_u32(uint32_t pos)
+{
+    return replay_log[pos] | (replay_log[pos + 1] << 8) |
+           (replay_log[pos + 2] << 16) | ((uint32_t)replay_log[pos + 3] << 24);
+}
+
+/*
+ * start_game - Put the game into the state a log starts from
+ *
+ * The whole game state is cleared first, so leftovers from an earlier
+ * game (inactive balls, dead particles) can't leak into the checksum.
+ */
+static void start_game(uint32_t seed, int num_players, int level, game_mode_t game_mode)
+{
+    memset(&game, 0, sizeof(game));
+    random_seed(seed);
+    breakout_init(num_players, game_mode);
+
+    if (level != 0)
+    {
+        game.level = level;
+        init_bricks();
+        init_balls();
+    }
+
+    game.sim_steps = 0;
+}
+
+/*
+ * replay_checksum - FNV-1a hash of the game state
+ *
+ * Only the simulation is hashed: the effects at the end of game_state_t
+ * are skipped by headless replays, and the render blend depends on
+ * wall-clock time.
+ */
+uint32_t replay_checksum()
+{
+    const uint8_t* bytes = (const uint8_t*)&game;
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < offsetof(game_state_t, particles); i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/* ============================================================================
+ * RECORDING
+ * ============================================================================
+ */
+
+/*
+ * replay_record_start - Start logging a new game
+ *
+ * Sets the game up from scratch with the given seed, so recording and
+ * replay start from exactly the same state.
+ */
+void replay_record_start(uint32_t seed, int num_players, int level, game_mode_t game_mode)
+{
+    start_game(seed, num_players, level, game_mode);
+
+    log_size = 0;
+    last_step = 0;
+    trailer_pos = 0;
+
+    put_byte('B'); put_byte('R'); put_byte('P'); put_byte('L');
+    put_byte(REPLAY_VERSION);
+    put_byte((uint8_t)game.num_players);
+    put_byte((uint8_t)level);
+    put_byte(SIM_SUBSTEPS);
+    put_u32(seed);
+    put_byte((uint8_t)game_mode);
+
+    mode = REPLAY_RECORDING;
+}
+
+/*
+ * record_entry - Append one entry, stamped with the current step
+ *
+ * Room for the end code and trailer is always kept free. When the log is
+ * full it is closed right there, with the game state so far, so it still
+ * replays and checks up to that point.
+ */
+static void record_entry(uint8_t code)
+{
+    if (mode != REPLAY_RECORDING)
+    {
+        return;
+    }
+
+    if (code != REPLAY_CODE_END &&
+        log_size + 2 * REPLAY_ENTRY_MAX + REPLAY_TRAILER_SIZE > REPLAY_MAX_BYTES)
+    {
+        replay_record_finish();
+        return;
+    }
+
+    uint32_t delta = game.sim_steps - last_step;
+    last_step = game.sim_steps;
+
+    while (delta >= 0x80)
+    {
+        put_byte((uint8_t)(delta | 0x80));
+        delta >>= 7;
+    }
+    put_byte((uint8_t)delta);
+    put_byte(code);
+}
+
+void replay_record_key(const key_event_t* event)
+{
+    // Scancode 0 is the keyboard's error code - never used by the game
+    if (event->scancode == 0)
+    {
+        return;
+    }
+
+    record_entry((event->scancode & 0x7F) | (event->pressed ? REPLAY_PRESSED : 0));
+}
+
+void replay_record_advance()
+{
+    record_entry(REPLAY_CODE_ADVANCE);
+}
+
+/*
+ * replay_record_finish - Close the log with the final game state
+ */
+void replay_record_finish()
+{
+    if (mode != REPLAY_RECORDING)
+    {
+        return;
+    }
+
+    record_entry(REPLAY_CODE_END);
+    trailer_pos = log_size;
+    put_u32(game.sim_steps);
+    put_u32(replay_checksum());
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        put_u32((uint32_t)game.players[p].score);
+    }
+
+    mode = REPLAY_OFF;
+}
+
+/*
+ * replay_data - The last recorded (or loaded) log
+ */
+const uint8_t* replay_data(uint32_t* size)
+{
+    *size = log_size;
+    return replay_log;
+}
+
+/* ============================================================================
+ * PLAYBACK
+ * ============================================================================
+ */
+
+/*
+ * decode_next - Read the next entry into next_step/next_code
+ *
+ * next_valid stays false if the log is cut off before its end code.
+ */
+static void decode_next()
+{
+    uint32_t delta = 0;
+    int shift = 0;
+
+    next_valid = false;
+
+    while (log_pos < log_size && shift < 35)
+    {
+        uint8_t byte = replay_log[log_pos++];
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+
+        if (!(byte & 0x80))
+        {
+            if (log_pos >= log_size)
+            {
+                return;   // Cut off before the code byte
+            }
+
+            next_code = replay_log[log_pos++];
+            next_step = last_step + delta;
+            last_step = next_step;
+            next_valid = true;
+
+            if (next_code == REPLAY_CODE_END && log_size - log_pos >= REPLAY_TRAILER_SIZE)
+            {
+                trailer_pos = log_pos;
+            }
+            return;
+        }
+    }
+}
+
+/*
+ * replay_load - Use a log from elsewhere (e.g. read from disk)
+ */
+bool replay_load(const uint8_t* data, uint32_t size)
+{
+    if (size < REPLAY_HEADER_SIZE || size > REPLAY_MAX_BYTES ||
+        data[0] != 'B' || data[1] != 'R' || data[2] != 'P' || data[3] != 'L' ||
+        data[4] != REPLAY_VERSION)
+    {
+        return false;
+    }
+
+    memcpy(replay_log, data, size);
+    log_size = size;
+    mode = REPLAY_OFF;
+    return true;
+}
+
+bool replay_available()
+{
+    return mode == REPLAY_OFF && log_size >= REPLAY_HEADER_SIZE;
+}
+
+/*
+ * replay_play_start - Set the game up from the log and start feeding it
+ *
+ * Returns false if the log was recorded at a different simulation rate,
+ * which would play out differently.
+ */
+bool replay_play_start(bool run_headless)
+{
+    if (!replay_available() || replay_log[7] != SIM_SUBSTEPS)
+    {
+        return false;
+    }
+
+    start_game(get_u32(8), replay_log[5], replay_log[6], (game_mode_t)replay_log[12]);
+
+    log_pos = REPLAY_HEADER_SIZE;
+    last_step = 0;
+    trailer_pos = 0;
+    decode_next();
+
+    headless = run_headless;
+    sound_set_muted(headless);
+    play_start_ticks = timer_get_ticks();
+    mode = REPLAY_PLAYING;
+    return true;
+}
+
+/*
+ * replay_next_key - Next key event due at the current step
+ *
+ * Stops at a screen time-out (taken by replay_advance_due()) and at the
+ * end of the log.
+ */
+bool replay_next_key(key_event_t* event)
+{
+    if (mode != REPLAY_PLAYING || !next_valid || next_step > game.sim_steps ||
+        next_code == REPLAY_CODE_ADVANCE || next_code == REPLAY_CODE_END)
+    {
+        return false;
+    }
+
+    event->scancode = next_code & 0x7F;
+    event->pressed = (next_code & REPLAY_PRESSED) != 0;
+    event->ascii = 0;
+
+    decode_next();
+    return true;
+}
+
+/*
+ * replay_advance_due - Should the current timed screen end?
+ *
+ * Yes for a logged time-out that is due now. Also yes if the log has
+ * already moved past this step (or ended): the recording had left the
+ * screen by then. That only happens once a replay has diverged, and
+ * without it the replay would wait forever on a frozen simulation.
+ */
+bool replay_advance_due()
+{
+    if (mode != REPLAY_PLAYING)
+    {
+        return false;
+    }
+
+    if (next_valid && next_step <= game.sim_steps)
+    {
+        if (next_code != REPLAY_CODE_ADVANCE)
+        {
+            return false;
+        }
+        decode_next();
+    }
+    return true;
+}
+
+bool replay_event_due()
+{
+    return mode == REPLAY_PLAYING && next_valid && next_step <= game.sim_steps;
+}
+
+/*
+ * replay_finished - Has the replay reached the end of the log?
+ */
+bool replay_finished()
+{
+    return mode == REPLAY_PLAYING &&
+           (!next_valid || (next_code == REPLAY_CODE_END && next_step <= game.sim_steps));
+}
+
+/*
+ * replay_play_finish - Stop playing and report how the game ended
+ */
+void replay_play_finish(replay_report_t* report)
+{
+    report->num_players = game.num_players;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        report->scores[p] = game.players[p].score;
+    }
+    report->steps = game.sim_steps;
+    report->frames = game.sim_steps / SIM_SUBSTEPS;
+    report->checksum = replay_checksum();
+    report->elapsed_ms = timer_get_ticks() - play_start_ticks;
+
+    // Only a replay that got to the recorded end has something to compare
+    report->has_expected = (trailer_pos != 0);
+    report->expected = report->has_expected ? get_u32(trailer_pos + 4) : 0;
+
+    sound_set_muted(false);
+    stop_sound();
+    headless = false;
+    mode = REPLAY_OFF;
+}
+
+replay_mode_t replay_mode()
+{
+    return mode;
+}
+
+bool replay_headless()
+{
+    return headless;
+}
+
+/* ============================================================================
+ * REPLAY SESSION
+ * ============================================================================
+ * Shown after a recorded game: the log is replayed headless straight away
+ * and the result compared with the recording. From there the replay can be
+ * watched at normal speed or run again.
+ */
+
+/*
+ * draw_hex - Draw a 32-bit value as 8 hex digits
+ */
+static void draw_hex(int x, int y, uint32_t value, uint8_t color)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char text[9];
+
+    for (int i = 0; i < 8; i++)
+    {
+        text[i] = digits[(value >> (28 - i * 4)) & 0xF];
+    }
+    text[8] = '\0';
+
+    text_draw(x, y, text, TEXT_FONT_LARGE, color);
+}
+
+/*
+ * draw_report - Show the result of a replay
+ */
+static void draw_report(const replay_report_t* report)
+{
+    vga_set_target(0);
+    vga_reset_clip();
+    vga_clear(0);
+
+    text_draw(8, 8, "REPLAY CHECK", TEXT_FONT_LARGE, 15);
+
+    text_draw(8, 36, "SCORE", TEXT_FONT_LARGE, 7);
+    for (int p = 0; p < report->num_players; p++)
+    {
+        text_draw_number(180 + p * 60, 38, report->scores[p], 14);
+    }
+
+    text_draw(8, 56, "FRAMES", TEXT_FONT_LARGE, 7);
+    text_draw_number(180, 58, (int)report->frames, 15);
+
+    text_draw(8, 76, "TIME MS", TEXT_FONT_LARGE, 7);
+    text_draw_number(180, 78, (int)report->elapsed_ms, 15);
+
+    text_draw(8, 96, "CHECKSUM", TEXT_FONT_LARGE, 7);
+    draw_hex(150, 96, report->checksum, 15);
+
+    text_draw(8, 116, "RECORDED", TEXT_FONT_LARGE, 7);
+    if (report->has_expected)
+    {
+        draw_hex(150, 116, report->expected, 15);
+
+        if (report->checksum == report->expected)
+        {
+            text_draw(8, 140, "MATCH", TEXT_FONT_LARGE, 10);
+        }
+        else
+        {
+            text_draw(8, 140, "DIVERGED", TEXT_FONT_LARGE, 12);
+        }
+    }
+    else
+    {
+        text_draw(150, 116, "NONE", TEXT_FONT_LARGE, 8);
+    }
+
+    text_draw(8, 176, "R WATCH  H AGAIN  ESC", TEXT_FONT_LARGE, 8);
+    vga_present();
+}
+
+/*
+ * run_replay - Play the log through the normal game loop
+ */
+static bool run_replay(bool run_headless, replay_report_t* report)
+{
+    if (!replay_play_start(run_headless))
+    {
+        return false;
+    }
+
+    if (!run_headless)
+    {
+        palette_fade_from(0);
+        palette_sync();
+    }
+
+    breakout_run();
+    replay_play_finish(report);
+    return true;
+}
+
+/*
+ * replay_session - Check the last recording and offer to watch it
+ *
+ * Returns when ESC is pressed (or there is nothing to replay).
+ */
+void replay_session()
+{
+    replay_report_t report;
+
+    if (!run_replay(true, &report))
+    {
+        return;
+    }
+
+    while (1)
+    {
+        palette_fade_from(0);
+        palette_sync();
+        draw_report(&report);
+
+        key_event_t event;
+        while (!keyboard_get_event(&event) || !event.pressed)
+        {
+        }
+
+        if (event.scancode == 0x13)          // R - watch at normal speed
+        {
+            run_replay(false, &report);
+        }
+        else if (event.scancode == 0x23)     // H - headless again
+        {
+            run_replay(true, &report);
+        }
+        else if (event.scancode == 0x01)     // ESC
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef BREAKOUT_REPLAY_H
+#define BREAKOUT_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard/keyboard.h"
+#include "breakout.h"
+
+/*
+ * Input recording and deterministic replay. A game is fully decided by its
+ * random seed, player count, starting level, game mode and the key events
+ * it handled (stamped with the simulation step), so that is all the log
+ * stores.
+ */
+
+// Largest log kept in memory (a few bytes per key event)
+#define REPLAY_MAX_BYTES 65536
+
+typedef enum {
+    REPLAY_OFF = 0,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING
+} replay_mode_t;
+
+// Outcome of a replay, compared against what the recording saw
+typedef struct {
+    int scores[MAX_PLAYERS];   // Final score per player
+    int num_players;
+    uint32_t frames;           // 60 Hz ticks simulated
+    uint32_t steps;            // Fixed simulation steps
+    uint32_t checksum;         // Checksum of the final game_state_t
+    uint32_t expected;         // Checksum stored by the recording
+    bool has_expected;         // Replay reached the end of a complete log
+    uint32_t elapsed_ms;       // Wall time the replay took
+} replay_report_t;
+
+// Recording (replay_record_start sets the game up, like breakout_init)
+void replay_record_start(uint32_t seed, int num_players, int level, game_mode_t game_mode);
+void replay_record_key(const key_event_t* event);
+void replay_record_advance();   // A screen timed out
+void replay_record_finish();    // Store final state after breakout_run returns
+const uint8_t* replay_data(uint32_t* size);   // The log, e.g. to save it
+
+// Playback
+bool replay_load(const uint8_t* data, uint32_t size);   // Use an external log
+bool replay_play_start(bool headless);                   // Set up the game from the log
+bool replay_next_key(key_event_t* event);   // Next key event due at this step
+bool replay_advance_due();                  // Consume a due screen time-out
+bool replay_event_due();                    // Anything due at this step?
+bool replay_finished();                     // Log used up
+void replay_play_finish(replay_report_t* report);
+
+replay_mode_t replay_mode();
+bool replay_headless();
+bool replay_available();                    // Is there a log to play?
+uint32_t replay_checksum();                 // Checksum of the current game state
+
+void replay_session();   // Check the last recording and offer to watch it
+
+#endif // BREAKOUT_REPLAY_H
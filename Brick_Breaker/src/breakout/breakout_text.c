@@ -0,0 +1,441 @@
+/*
+ * breakout_text.c - Shared bitmap font engine
+ * 
+ * The menu and the in-game UI both draw text with this module. Instead of
+ * drawing every letter as a handful of rectangles each frame, we:
+ * - Rasterize every glyph once at startup into an atlas of row masks
+ *   (one byte per row, bit 7 = leftmost pixel)
+ * - Turn a whole string into a list of horizontal spans the first time it
+ *   is drawn, and keep that list in a small cache keyed by text and color
+ * - Draw cached strings as a few span fills
+ * 
+ * Two faces are available: the 8x12 block letters and the 5x7 score digits.
+ */
+
+#include "graphics/vga.h"
+#include "string/string.h"
+#include "breakout_text.h"
+
+/* ============================================================================
+ * FONT DATA
+ * ============================================================================
+ */
+
+#define GLYPH_FIRST 32    // ' '
+#define GLYPH_LAST 95     // '_'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+#define GLYPH_MAX_HEIGHT 12
+
+// Cache limits
+#define TEXT_CACHE_SIZE 12
+#define TEXT_MAX_LENGTH 24
+#define TEXT_MAX_SPANS 512
+
+typedef struct {
+    int advance;           // Pixels from one character to the next
+    int height;            // Glyph height in pixels
+    int gap;               // Empty columns at the right of a glyph cell
+} font_metrics_t;
+
+static const font_metrics_t font_metrics[TEXT_FONT_COUNT] = {
+    {8, 12, 2},            // TEXT_FONT_LARGE
+    {6, 7, 1}              // TEXT_FONT_SMALL
+};
+
+/*
+ * large_glyphs - Block letters described as up to 6 rectangles each
+ * 
+ * Each rectangle is {x, y, width, height} inside an 8x12 cell. These are
+ * only read once, when the atlas is built.
+ */
+typedef struct {
+    char letter;
+    uint8_t count;
+    uint8_t rects[6][4];
+} glyph_shape_t;
+
+static const glyph_shape_t large_glyphs[] = {
+    {'1', 3, {{2, 0, 2, 12}, {0, 10, 6, 2}, {0, 0, 2, 3}}},
+    {'2', 5, {{0, 0, 6, 2}, {4, 0, 2, 5}, {0, 4, 6, 2}, {0, 6, 2, 4}, {0, 10, 6, 2}}},
+    {'3', 4, {{0, 0, 6, 2}, {4, 0, 2, 12}, {0, 5, 6, 2}, {0, 10, 6, 2}}},
+    {'4', 3, {{0, 0, 2, 6}, {4, 0, 2, 12}, {0, 5, 6, 2}}},
+    {'A', 4, {{0, 0, 6, 2}, {0, 0, 2, 12}, {4, 0, 2, 12}, {0, 6, 6, 2}}},
+    {'B', 6, {{0, 0, 2, 12}, {0, 0, 5, 2}, {0, 5, 5, 2}, {0, 10, 5, 2}, {4, 0, 2, 5}, {4, 6, 2, 4}}},
+    {'C', 3, {{0, 0, 6, 2}, {0, 0, 2, 12}, {0, 10, 6, 2}}},
+    {'D', 4, {{0, 0, 2, 12}, {0, 0, 5, 2}, {0, 10, 5, 2}, {4, 2, 2, 8}}},
+    {'E', 4, {{0, 0, 2, 12}, {0, 0, 6, 2}, {0, 5, 5, 2}, {0, 10, 6, 2}}},
+    {'H', 3, {{0, 0, 2, 12}, {4, 0, 2, 12}, {0, 5, 6, 2}}},
+    {'I', 3, {{0, 0, 6, 2}, {2, 0, 2, 12}, {0, 10, 6, 2}}},
+    {'K', 4, {{0, 0, 2, 12}, {4, 0, 2, 4}, {2, 5, 2, 2}, {4, 8, 2, 4}}},
+    {'L', 2, {{0, 0, 2, 12}, {0, 10, 6, 2}}},
+    {'M', 4, {{0, 0, 2, 12}, {5, 0, 2, 12}, {2, 2, 1, 3}, {4, 2, 1, 3}}},
+    {'N', 5, {{0, 0, 2, 12}, {5, 0, 2, 12}, {1, 3, 2, 2}, {2, 5, 2, 2}, {3, 7, 2, 2}}},
+    {'O', 4, {{0, 0, 6, 2}, {0, 0, 2, 12}, {4, 0, 2, 12}, {0, 10, 6, 2}}},
+    {'P', 4, {{0, 0, 2, 12}, {0, 0, 6, 2}, {4, 0, 2, 6}, {0, 5, 6, 2}}},
+    {'R', 5, {{0, 0, 2, 12}, {0, 0, 6, 2}, {4, 0, 2, 6}, {0, 5, 6, 2}, {4, 7, 2, 5}}},
+    {'S', 5, {{0, 0, 6, 2}, {0, 0, 2, 6}, {0, 5, 6, 2}, {4, 6, 2, 4}, {0, 10, 6, 2}}},
+    {'T', 2, {{0, 0, 8, 2}, {3, 0, 2, 12}}},
+    {'V', 5, {{0, 0, 2, 8}, {5, 0, 2, 8}, {1, 8, 2, 2}, {4, 8, 2, 2}, {2, 10, 2, 2}}},
+    {'Y', 4, {{0, 0, 2, 6}, {4, 0, 2, 6}, {1, 5, 4, 2}, {2, 6, 2, 6}}},
+};
+
+// Unknown characters are drawn as a small dot
+static const glyph_shape_t unknown_glyph = {'?', 1, {{2, 5, 2, 2}}};
+
+/*
+ * digit_font - 5x7 pixel representation of digits 0-9
+ * 
+ * Each digit is 7 rows tall. Each row is a byte where bits represent pixels.
+ * Bit 4 = leftmost pixel, bit 0 = rightmost pixel.
+ */
+static const uint8_t digit_font[10][7] = {
+    {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F},  // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x1F},  // 1
+    {0x1F, 0x01, 0x01, 0x1F, 0x10, 0x10, 0x1F},  // 2
+    {0x1F, 0x01, 0x01, 0x1F, 0x01, 0x01, 0x1F},  // 3
+    {0x11, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x01},  // 4
+    {0x1F, 0x10, 0x10, 0x1F, 0x01, 0x01, 0x1F},  // 5
+    {0x1F, 0x10, 0x10, 0x1F, 0x11, 0x11, 0x1F},  // 6
+    {0x1F, 0x01, 0x01, 0x02, 0x04, 0x08, 0x10},  // 7
+    {0x1F, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x1F},  // 8
+    {0x1F, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x1F},  // 9
+};
+
+/* ============================================================================
+ * GLYPH ATLAS AND STRING CACHE
+ * ============================================================================
+ */
+
+// atlas[font][glyph][row] - row mask, bit 7 = leftmost pixel
+static uint8_t atlas[TEXT_FONT_COUNT][GLYPH_COUNT][GLYPH_MAX_HEIGHT];
+static bool atlas_ready = false;
+
+// One horizontal run of pixels, relative to the text origin
+typedef struct {
+    uint16_t x;
+    uint8_t y;
+    uint8_t length;
+} text_span_t;
+
+// A rendered string
+typedef struct {
+    bool valid;
+    char text[TEXT_MAX_LENGTH + 1];
+    text_font_t font;
+    uint8_t color;
+    uint32_t last_used;    // For least-recently-used replacement
+    int num_spans;
+    text_span_t spans[TEXT_MAX_SPANS];
+} text_cache_entry_t;
+
+static text_cache_entry_t text_cache[TEXT_CACHE_SIZE];
+static uint32_t text_cache_clock = 0;
+
+/*
+ * rasterize_shape - Turn a rectangle list into row masks
+ */
+static void rasterize_shape(uint8_t* rows, const glyph_shape_t* shape)
+{
+    for (int r = 0; r < shape->count; r++)
+    {
+        const uint8_t* rect = shape->rects[r];
+        
+        // Bits for columns rect[0] .. rect[0] + rect[2] - 1
+        uint8_t mask = (uint8_t)(0xFF << (8 - rect[2])) >> rect[0];
+        
+        for (int y = rect[1]; y < rect[1] + rect[3] && y < GLYPH_MAX_HEIGHT; y++)
+        {
+            rows[y] |= mask;
+        }
+    }
+}
+
+/*
+ * text_init - Build the glyph atlas
+ */
+void text_init()
+{
+    // Block letters: everything starts as the "unknown" dot
+    for (int g = 0; g < GLYPH_COUNT; g++)
+    {
+        for (int row = 0; row < GLYPH_MAX_HEIGHT; row++)
+        {
+            atlas[TEXT_FONT_LARGE][g][row] = 0;
+            atlas[TEXT_FONT_SMALL][g][row] = 0;
+        }
+        
+        if (g + GLYPH_FIRST != ' ')
+        {
+            rasterize_shape(atlas[TEXT_FONT_LARGE][g], &unknown_glyph);
+        }
+    }
+    
+    for (int i = 0; i < (int)(sizeof(large_glyphs) / sizeof(large_glyphs[0])); i++)
+    {
+        uint8_t* rows = atlas[TEXT_FONT_LARGE][large_glyphs[i].letter - GLYPH_FIRST];
+        for (int row = 0; row < GLYPH_MAX_HEIGHT; row++)
+        {
+            rows[row] = 0;
+        }
+        rasterize_shape(rows, &large_glyphs[i]);
+    }
+    
+    // Score digits: shift the 5-bit rows up so bit 7 is the leftmost pixel
+    for (int d = 0; d < 10; d++)
+    {
+        for (int row = 0; row < 7; row++)
+        {
+            atlas[TEXT_FONT_SMALL]['0' + d - GLYPH_FIRST][row] = digit_font[d][row] << 3;
+        }
+    }
+    
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        text_cache[i].valid = false;
+    }
+    
+    atlas_ready = true;
+}
+
+/*
+ * glyph_rows - Find the atlas rows for a character
+ */
+static const uint8_t* glyph_rows(char c, text_font_t font)
+{
+    // Make letter uppercase
+    if (c >= 'a' && c <= 'z')
+    {
+        c = c - 32;
+    }
+    
+    if (c < GLYPH_FIRST || c > GLYPH_LAST)
+    {
+        c = '?';  // Not in the atlas - draws the unknown dot
+    }
+    
+    return atlas[font][c - GLYPH_FIRST];
+}
+
+/*
+ * blit_row_mask - Draw one glyph row as horizontal spans
+ */
+static void blit_row_mask(int x, int y, uint8_t mask, uint8_t color)
+{
+    int col = 0;
+    while (mask)
+    {
+        // Skip to the next set bit, then measure the run
+        while (!(mask & 0x80))
+        {
+            mask <<= 1;
+            col++;
+        }
+        
+        int start = col;
+        while (mask & 0x80)
+        {
+            mask <<= 1;
+            col++;
+        }
+        
+        vga_draw_hline(x + start, y, col - start, color);
+    }
+}
+
+/*
+ * build_spans - Rasterize a string into a cache entry
+ * 
+ * Returns false if the string has too many spans to cache.
+ */
+static bool build_spans(text_cache_entry_t* entry)
+{
+    const font_metrics_t* metrics = &font_metrics[entry->font];
+    entry->num_spans = 0;
+    
+    for (int row = 0; row < metrics->height; row++)
+    {
+        for (int i = 0; entry->text[i] != '\0'; i++)
+        {
+            uint8_t mask = glyph_rows(entry->text[i], entry->font)[row];
+            int col = 0;
+            
+            while (mask)
+            {
+                while (!(mask & 0x80))
+                {
+                    mask <<= 1;
+                    col++;
+                }
+                
+                int start = col;
+                while (mask & 0x80)
+                {
+                    mask <<= 1;
+                    col++;
+                }
+                
+                int span_x = i * metrics->advance + start;
+                
+                // Join with a run that ends exactly where this one starts
+                if (entry->num_spans > 0)
+                {
+                    text_span_t* last = &entry->spans[entry->num_spans - 1];
+                    if (last->y == row && last->x + last->length == span_x)
+                    {
+                        last->length += col - start;
+                        continue;
+                    }
+                }
+                
+                if (entry->num_spans == TEXT_MAX_SPANS)
+                {
+                    return false;
+                }
+                
+                entry->spans[entry->num_spans].x = span_x;
+                entry->spans[entry->num_spans].y = row;
+                entry->spans[entry->num_spans].length = col - start;
+                entry->num_spans++;
+            }
+        }
+    }
+    
+    return true;
+}
+
+/*
+ * find_cached - Look up (or render) a string in the cache
+ * 
+ * Returns 0 if the string can't be cached (too long or too complex).
+ */
+static text_cache_entry_t* find_cached(const char* text, text_font_t font, uint8_t color)
+{
+    text_cache_entry_t* victim = &text_cache[0];
+    text_cache_clock++;
+    
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        text_cache_entry_t* entry = &text_cache[i];
+        
+        if (entry->valid && entry->font == font && entry->color == color &&
+            strncmp(entry->text, text, TEXT_MAX_LENGTH + 1) == 0)
+        {
+            entry->last_used = text_cache_clock;
+            return entry;
+        }
+        
+        // Remember the best slot to replace: empty, else least recently used
+        if (!entry->valid || (victim->valid && entry->last_used < victim->last_used))
+        {
+            victim = entry;
+        }
+    }
+    
+    if (strnlen(text, TEXT_MAX_LENGTH + 1) > TEXT_MAX_LENGTH)
+    {
+        return 0;
+    }
+    
+    strncpy(victim->text, text, TEXT_MAX_LENGTH + 1);
+    victim->font = font;
+    victim->color = color;
+    victim->last_used = text_cache_clock;
+    victim->valid = build_spans(victim);
+    
+    return victim->valid ? victim : 0;
+}
+
+/* ============================================================================
+ * PUBLIC DRAWING FUNCTIONS
+ * ============================================================================
+ */
+
+/*
+ * text_draw - Draw a string
+ * 
+ * Parameters:
+ *   x, y - Top-left position
+ *   text - The string (lowercase is drawn as uppercase)
+ *   font - Which face to use
+ *   color - VGA color
+ */
+void text_draw(int x, int y, const char* text, text_font_t font, uint8_t color)
+{
+    if (!atlas_ready)
+    {
+        text_init();
+    }
+    
+    text_cache_entry_t* entry = find_cached(text, font, color);
+    if (entry)
+    {
+        for (int i = 0; i < entry->num_spans; i++)
+        {
+            vga_draw_hline(x + entry->spans[i].x, y + entry->spans[i].y,
+                           entry->spans[i].length, color);
+        }
+        return;
+    }
+    
+    // Too big for the cache - blit straight from the atlas
+    const font_metrics_t* metrics = &font_metrics[font];
+    for (int i = 0; text[i] != '\0'; i++)
+    {
+        const uint8_t* rows = glyph_rows(text[i], font);
+        for (int row = 0; row < metrics->height; row++)
+        {
+            blit_row_mask(x + i * metrics->advance, y + row, rows[row], color);
+        }
+    }
+}
+
+/*
+ * text_draw_number - Draw a number with the small digit font
+ * 
+ * Numbers are right-aligned: x is the left edge of the last digit and
+ * earlier digits grow to the left. Only the last 6 digits are shown.
+ */
+void text_draw_number(int x, int y, int number, uint8_t color)
+{
+    if (number < 0)
+    {
+        number = 0;  // Don't handle negative numbers
+    }
+    
+    // Extract digits in reverse order, then flip them into a string
+    char reversed[6];
+    int num_digits = 0;
+    do
+    {
+        reversed[num_digits++] = '0' + (number % 10);
+        number /= 10;
+    } while (number > 0 && num_digits < 6);
+    
+    char buffer[7];
+    for (int i = 0; i < num_digits; i++)
+    {
+        buffer[i] = reversed[num_digits - 1 - i];
+    }
+    buffer[num_digits] = '\0';
+    
+    int advance = font_metrics[TEXT_FONT_SMALL].advance;
+    text_draw(x - (num_digits - 1) * advance, y, buffer, TEXT_FONT_SMALL, color);
+}
+
+/*
+ * text_measure - Width of a string in pixels (no trailing gap)
+ * 
+ * Handy for centering: x = center - text_measure(text, font) / 2
+ */
+int text_measure(const char* text, text_font_t font)
+{
+    int length = strlen(text);
+    if (length == 0)
+    {
+        return 0;
+    }
+    
+    // Last glyph doesn't need the gap after it
+    const font_metrics_t* metrics = &font_metrics[font];
+    return length * metrics->advance - metrics->gap;
+}
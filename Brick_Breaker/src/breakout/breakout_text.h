@@ -0,0 +1,20 @@
+#ifndef BREAKOUT_TEXT_H
+#define BREAKOUT_TEXT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Font faces
+typedef enum {
+    TEXT_FONT_LARGE = 0,   // 8x12 block letters (menus, screens)
+    TEXT_FONT_SMALL = 1,   // 5x7 digits (score, level number)
+    TEXT_FONT_COUNT = 2
+} text_font_t;
+
+// Public functions
+void text_init();      // Build the glyph atlas (call once at startup)
+void text_draw(int x, int y, const char* text, text_font_t font, uint8_t color);
+void text_draw_number(int x, int y, int number, uint8_t color);  // Right-aligned, small font
+int text_measure(const char* text, text_font_t font);            // Width in pixels
+
+#endif // BREAKOUT_TEXT_H
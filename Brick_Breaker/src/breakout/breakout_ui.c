@@ -8,7 +8,7 @@
  * - Winner/game over screen
  * - Text and number rendering
  * 
- * These screens use simple pixel art for text since we don't have a font library!
+ * Text and numbers are drawn with the shared font engine (breakout_text.c).
  * 
  * Author: CS Student
  * Date: December 2024
@@ -18,313 +18,15 @@
 #include "graphics/vga.h"
 #include "timer/timer.h"
 #include "breakout.h"
+#include "breakout_text.h"
+#include "breakout_profile.h"
 
 // External references
 extern game_state_t game;
 extern level_t levels[MAX_LEVELS];
 extern void draw_rect(int x, int y, int width, int height, uint8_t color);
 extern void draw_pixel(int x, int y, uint8_t color);
-
-/* ============================================================================
- * SIMPLE PIXEL FONT FOR TEXT RENDERING
- * ============================================================================
- * Drawing letters pixel by pixel for a retro look!
- */
-
-/*
- * draw_letter - Draw a single letter in pixel art style
- * 
- * This draws simple block letters. Not fancy, but readable!
- */
-static void draw_letter(int x, int y, char letter, uint8_t color)
-{
-    // Make letter uppercase
-    if (letter >= 'a' && letter <= 'z')
-    {
-        letter = letter - 32;
-    }
-    
-    switch (letter)
-    {
-        case '1':
-            draw_rect(x + 2, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            draw_rect(x, y, 2, 3, color);
-            break;
-            
-        case '2':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 5, color);
-            draw_rect(x, y + 4, 6, 2, color);
-            draw_rect(x, y + 6, 2, 4, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '3':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '4':
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'A':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 6, 6, 2, color);
-            break;
-            
-        case 'B':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 5, 2, color);
-            draw_rect(x, y + 5, 5, 2, color);
-            draw_rect(x, y + 10, 5, 2, color);
-            draw_rect(x + 4, y, 2, 5, color);
-            draw_rect(x + 4, y + 6, 2, 4, color);
-            break;
-            
-        case 'C':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'D':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 5, 2, color);
-            draw_rect(x, y + 10, 5, 2, color);
-            draw_rect(x + 4, y + 2, 2, 8, color);
-            break;
-            
-        case 'E':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y + 5, 5, 2, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'H':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'I':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 2, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'K':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 4, color);
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            draw_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'L':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'M':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 5, y, 2, 12, color);
-            draw_rect(x + 2, y + 2, 1, 3, color);
-            draw_rect(x + 4, y + 2, 1, 3, color);
-            break;
-            
-        case 'N':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 5, y, 2, 12, color);
-            draw_rect(x + 1, y + 3, 2, 2, color);
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            draw_rect(x + 3, y + 7, 2, 2, color);
-            break;
-            
-        case 'O':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'P':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'R':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x + 4, y + 7, 2, 5, color);
-            break;
-            
-        case 'S':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x + 4, y + 6, 2, 4, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'T':
-            draw_rect(x, y, 8, 2, color);
-            draw_rect(x + 3, y, 2, 12, color);
-            break;
-            
-        case 'V':
-            draw_rect(x, y, 2, 8, color);
-            draw_rect(x + 5, y, 2, 8, color);
-            draw_rect(x + 1, y + 8, 2, 2, color);
-            draw_rect(x + 4, y + 8, 2, 2, color);
-            draw_rect(x + 2, y + 10, 2, 2, color);
-            break;
-            
-        case 'Y':
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x + 1, y + 5, 4, 2, color);
-            draw_rect(x + 2, y + 6, 2, 6, color);
-            break;
-            
-        case ' ':
-            // Space - do nothing
-            break;
-            
-        default:
-            // Unknown character - draw a small dot
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            break;
-    }
-}
-
-/*
- * draw_text - Draw a string of text
- */
-static void draw_text(int x, int y, const char* text, uint8_t color)
-{
-    int cursor_x = x;
-    
-    for (int i = 0; text[i] != '\0'; i++)
-    {
-        draw_letter(cursor_x, y, text[i], color);
-        cursor_x += 8;  // Move to next character position
-    }
-}
-
-/* ============================================================================
- * DIGIT FONT SYSTEM
- * ============================================================================
- * We need to draw numbers for scores and lives. This is a simple 5x7 pixel
- * font for digits 0-9.
- */
-
-/*
- * digit_font - 5x7 pixel representation of digits 0-9
- * 
- * Each digit is 7 rows tall. Each row is a byte where bits represent pixels.
- * Bit 4 = leftmost pixel, bit 0 = rightmost pixel.
- */
-static const uint8_t digit_font[10][7] = {
-    {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F},  // 0
-    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x1F},  // 1
-    {0x1F, 0x01, 0x01, 0x1F, 0x10, 0x10, 0x1F},  // 2
-    {0x1F, 0x01, 0x01, 0x1F, 0x01, 0x01, 0x1F},  // 3
-    {0x11, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x01},  // 4
-    {0x1F, 0x10, 0x10, 0x1F, 0x01, 0x01, 0x1F},  // 5
-    {0x1F, 0x10, 0x10, 0x1F, 0x11, 0x11, 0x1F},  // 6
-    {0x1F, 0x01, 0x01, 0x02, 0x04, 0x08, 0x10},  // 7
-    {0x1F, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x1F},  // 8
-    {0x1F, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x1F},  // 9
-};
-
-/*
- * draw_digit - Draw a single digit
- * 
- * Parameters:
- *   x, y - Top-left position
- *   digit - Which digit (0-9)
- *   color - VGA color to use
- */
-static void draw_digit(int x, int y, int digit, uint8_t color)
-{
-    if (digit < 0 || digit > 9)
-    {
-        return;  // Invalid digit
-    }
-    
-    // Draw each row of the digit
-    for (int row = 0; row < 7; row++)
-    {
-        uint8_t line = digit_font[digit][row];
-        
-        // Draw each pixel in the row
-        for (int col = 0; col < 5; col++)
-        {
-            // Check if this bit is set
-            if (line & (1 << (4 - col)))
-            {
-                vga_set_pixel(x + col, y + row, color);
-            }
-        }
-    }
-}
-
-/*
- * draw_number - Draw a multi-digit number
- * 
- * Numbers are drawn right-to-left so they're right-aligned.
- * 
- * Parameters:
- *   x, y - Right edge position (numbers grow to the left)
- *   number - The number to draw
- *   color - VGA color
- */
-static void draw_number(int x, int y, int number, uint8_t color)
-{
-    if (number < 0)
-    {
-        number = 0;  // Don't handle negative numbers
-    }
-    
-    // Extract digits (up to 6 digits max)
-    int digits[6];
-    int num_digits = 0;
-    
-    // Handle zero specially
-    if (number == 0)
-    {
-        digits[0] = 0;
-        num_digits = 1;
-    }
-    else
-    {
-        // Extract digits in reverse order
-        int temp = number;
-        while (temp > 0 && num_digits < 6)
-        {
-            digits[num_digits++] = temp % 10;
-            temp /= 10;
-        }
-    }
-    
-    // Draw digits from right to left
-    for (int i = 0; i < num_digits; i++)
-    {
-        draw_digit(x - (i * 6), y, digits[i], color);
-    }
-}
+extern void draw_border(int x, int y, int width, int height, uint8_t color);
 
 /* ============================================================================
  * HUD (HEADS-UP DISPLAY)
@@ -373,7 +75,7 @@ void draw_hud()
     }
     
     // Draw score (right-aligned from position 75)
-    draw_number(75, 7, player->score, player_color);
+    text_draw_number(75, 7, player->score, player_color);
     
     // Draw lives as hearts at bottom of screen
     for (int i = 0; i < player->lives && i < 5; i++)
@@ -388,7 +90,12 @@ void draw_hud()
     }
     
     // Draw current level indicator (top right)
-    draw_number(VGA_WIDTH - 30, 7, game.level + 1, 11);
+    text_draw_number(VGA_WIDTH - 30, 7, game.level + 1, 11);
+    
+#ifdef BREAKOUT_PROFILE
+    // Frame-time bar graph (F3)
+    profile_draw_overlay();
+#endif
 }
 
 /* ============================================================================
@@ -469,18 +176,7 @@ void draw_countdown(int number)
         // Draw glowing border effect
         for (int i = 0; i < 3; i++)
         {
-            // Top
-            for (int dx = -5 - i; dx < 45 + i; dx++)
-                draw_pixel(x + dx, y - 5 - i, color - 4);
-            // Bottom
-            for (int dx = -5 - i; dx < 45 + i; dx++)
-                draw_pixel(x + dx, y + 65 + i, color - 4);
-            // Left
-            for (int dy = -5 - i; dy < 65 + i; dy++)
-                draw_pixel(x - 5 - i, y + dy, color - 4);
-            // Right
-            for (int dy = -5 - i; dy < 65 + i; dy++)
-                draw_pixel(x + 45 + i, y + dy, color - 4);
+            draw_border(x - 5 - i, y - 5 - i, 51 + i * 2, 71 + i * 2, color - 4);
         }
     }
     else
@@ -517,19 +213,10 @@ void draw_countdown(int number)
         int border_h = 70;
         
         // Thick white border
-        for (int i = 0; i < 4; i++)
-        {
-            for (int j = 0; j < border_w; j++)
-            {
-                draw_pixel(border_x + j, border_y + i, 15);
-                draw_pixel(border_x + j, border_y + border_h - 1 - i, 15);
-            }
-            for (int j = 0; j < border_h; j++)
-            {
-                draw_pixel(border_x + i, border_y + j, 15);
-                draw_pixel(border_x + border_w - 1 - i, border_y + j, 15);
-            }
-        }
+        draw_rect(border_x, border_y, border_w, 4, 15);
+        draw_rect(border_x, border_y + border_h - 4, border_w, 4, 15);
+        draw_rect(border_x, border_y, 4, border_h, 15);
+        draw_rect(border_x + border_w - 4, border_y, 4, border_h, 15);
         
         // Pulse effect rings
         for (int i = 1; i <= 3; i++)
@@ -537,18 +224,8 @@ void draw_countdown(int number)
             int offset = i * 10;
             uint8_t ring_color = 10 - (i * 2);
             
-            // Top
-            for (int j = 0; j < border_w + offset * 2; j++)
-                draw_pixel(border_x - offset + j, border_y - offset, ring_color);
-            // Bottom
-            for (int j = 0; j < border_w + offset * 2; j++)
-                draw_pixel(border_x - offset + j, border_y + border_h + offset - 1, ring_color);
-            // Left
-            for (int j = 0; j < border_h + offset * 2; j++)
-                draw_pixel(border_x - offset, border_y - offset + j, ring_color);
-            // Right
-            for (int j = 0; j < border_h + offset * 2; j++)
-                draw_pixel(border_x + border_w + offset - 1, border_y - offset + j, ring_color);
+            draw_border(border_x - offset, border_y - offset,
+                        border_w + offset * 2, border_h + offset * 2, ring_color);
         }
     }
 }
@@ -580,27 +257,15 @@ void draw_level_start_screen()
     draw_rect(box_x, box_y, box_w, box_h, bg_color);
     draw_rect(box_x + 3, box_y + 3, box_w - 6, box_h - 6, 0);
     
-    // Draw white border for emphasis
-    for (int i = 0; i < box_w; i++)
-    {
-        vga_set_pixel(box_x + i, box_y, 15);
-        vga_set_pixel(box_x + i, box_y + 1, 15);
-        vga_set_pixel(box_x + i, box_y + box_h - 1, 15);
-        vga_set_pixel(box_x + i, box_y + box_h - 2, 15);
-    }
-    for (int i = 0; i < box_h; i++)
-    {
-        vga_set_pixel(box_x, box_y + i, 15);
-        vga_set_pixel(box_x + 1, box_y + i, 15);
-        vga_set_pixel(box_x + box_w - 1, box_y + i, 15);
-        vga_set_pixel(box_x + box_w - 2, box_y + i, 15);
-    }
+    // Draw white border for emphasis (2 pixels thick)
+    vga_draw_border(box_x, box_y, box_w, box_h, 15);
+    vga_draw_border(box_x + 1, box_y + 1, box_w - 2, box_h - 2, 15);
     
     int text_y = box_y + 15;
     int text_x = box_x + 20;
     
     // Draw "LEVEL" using our text function
-    draw_text(text_x, text_y, "LEVEL", 15);
+    text_draw(text_x, text_y, "LEVEL", TEXT_FONT_LARGE, 15);
     
     // Draw level number (bigger, next to LEVEL text)
     char level_num[2];
@@ -616,17 +281,17 @@ void draw_level_start_screen()
     {
         for (int sy = 0; sy < 2; sy++)
         {
-            draw_text(num_x + scale, num_y + sy, level_num, bg_color);
+            text_draw(num_x + scale, num_y + sy, level_num, TEXT_FONT_LARGE, bg_color);
         }
     }
     
     // Draw level name below (use the actual level name from data)
     text_y += 20;
-    text_x = box_x + box_w / 2 - 30;
     
-    // Get level name and draw it
+    // Get level name and draw it centered in the box
     char* level_name = levels[game.level].name;
-    draw_text(text_x, text_y, level_name, 15);
+    text_x = box_x + box_w / 2 - text_measure(level_name, TEXT_FONT_LARGE) / 2;
+    text_draw(text_x, text_y, level_name, TEXT_FONT_LARGE, 15);
     
     // Draw mini preview of brick pattern
     text_y += 18;
@@ -682,17 +347,17 @@ void draw_turn_transition()
     draw_rect(text_x - 7, text_y - 7, 134, 44, 0);
     
     // Draw "PLAYER" text
-    draw_text(text_x, text_y, "PLAYER", 15);
+    text_draw(text_x, text_y, "PLAYER", TEXT_FONT_LARGE, 15);
     
     // Draw player number
     char player_num[2];
     player_num[0] = '1' + game.current_player;
     player_num[1] = '\0';
     
-    draw_text(text_x + 56, text_y, player_num, color);
+    text_draw(text_x + 56, text_y, player_num, TEXT_FONT_LARGE, color);
     
     // Draw "TURN" text below
-    draw_text(text_x + 20, text_y + 18, "TURN", 15);
+    text_draw(text_x + 20, text_y + 18, "TURN", TEXT_FONT_LARGE, 15);
 }
 
 /* ============================================================================
@@ -746,63 +411,51 @@ void draw_winner_screen()
     draw_rect(box_x, box_y, box_w, box_h, 0);
 
     // Thick border
-    for (int i = 0; i < box_w; i++)
-    {
-        vga_set_pixel(box_x + i, box_y, accent);
-        vga_set_pixel(box_x + i, box_y + 1, accent);
-        vga_set_pixel(box_x + i, box_y + box_h - 1, accent);
-        vga_set_pixel(box_x + i, box_y + box_h - 2, accent);
-    }
-    for (int i = 0; i < box_h; i++)
-    {
-        vga_set_pixel(box_x, box_y + i, accent);
-        vga_set_pixel(box_x + 1, box_y + i, accent);
-        vga_set_pixel(box_x + box_w - 1, box_y + i, accent);
-        vga_set_pixel(box_x + box_w - 2, box_y + i, accent);
-    }
+    vga_draw_border(box_x, box_y, box_w, box_h, accent);
+    vga_draw_border(box_x + 1, box_y + 1, box_w - 2, box_h - 2, accent);
 
     int text_y = box_y + 15;
     int text_x = box_x + 25;
 
     if (is_game_over)
     {
-        draw_text(text_x + 15, text_y, "GAME", 15);
-        draw_text(text_x + 15, text_y + 18, "OVER", 15);
+        text_draw(text_x + 15, text_y, "GAME", TEXT_FONT_LARGE, 15);
+        text_draw(text_x + 15, text_y + 18, "OVER", TEXT_FONT_LARGE, 15);
     }
     else if (winner >= 0)
     {
-        draw_text(text_x + 15, text_y, "WINNER", 15);
+        text_draw(text_x + 15, text_y, "WINNER", TEXT_FONT_LARGE, 15);
 
         text_y += 20;
-        draw_text(text_x + 20, text_y, "PLAYER", 15);
+        text_draw(text_x + 20, text_y, "PLAYER", TEXT_FONT_LARGE, 15);
 
         char winner_num[2];
         winner_num[0] = '1' + winner;
         winner_num[1] = '\0';
 
         // Use white (not bg color) so it's always readable
-        draw_text(text_x + 72, text_y, winner_num, 15);
+        text_draw(text_x + 72, text_y, winner_num, TEXT_FONT_LARGE, 15);
     }
     else
     {
-        draw_text(text_x + 55, text_y, "TIE", 15);
+        text_draw(text_x + 55, text_y, "TIE", TEXT_FONT_LARGE, 15);
     }
 
     // Show scores
     text_y += 30;
     text_x = box_x + 20;
 
-    draw_text(text_x, text_y, "P1", 14);
-    draw_number(text_x + 50, text_y, game.players[0].score, 14);
+    text_draw(text_x, text_y, "P1", TEXT_FONT_LARGE, 14);
+    text_draw_number(text_x + 50, text_y, game.players[0].score, 14);
 
     if (game.num_players == 2)
     {
         text_x = box_x + 90;
-        draw_text(text_x, text_y, "P2", 11);
-        draw_number(text_x + 50, text_y, game.players[1].score, 11);
+        text_draw(text_x, text_y, "P2", TEXT_FONT_LARGE, 11);
+        text_draw_number(text_x + 50, text_y, game.players[1].score, 11);
     }
 
     // PRESS SPACE
     text_y += 20;
-    draw_text(box_x + 25, text_y, "PRESS SPACE", 8);
+    text_draw(box_x + 25, text_y, "PRESS SPACE", TEXT_FONT_LARGE, 8);
 }
@@ -19,6 +19,11 @@ echo "========================================="
 CC="i686-elf-gcc"
 CFLAGS="-I../../ -I../keyboard -I../graphics -I../timer -I../io -g -ffreestanding -falign-jumps -falign-functions -falign-labels -falign-loops -fstrength-reduce -fomit-frame-pointer -finline-functions -fno-builtin -nostdlib -nostartfiles -nodefaultlibs -Wall -O0 -Wno-unused-function -Wno-unused-label -Wno-unused-parameter -Wno-unused-variable -Wno-cpp -Wno-implicit-function-declaration -std=gnu99"
 
+# Frame-time profiler is compiled out unless PROFILE=1
+if [ "$PROFILE" = "1" ]; then
+    CFLAGS="$CFLAGS -DBREAKOUT_PROFILE"
+fi
+
 # Output directory
 BUILD_DIR="../../build/breakout"
 
@@ -28,12 +33,16 @@ mkdir -p $BUILD_DIR
 # List of source files to compile
 FILES=(
     "breakout_audio.c"
+    "breakout_events.c"    # Per-step gameplay event queue
     "breakout_graphics.c"
     "breakout_main.c"
     "breakout_menu.c"      # Title screen with player selection
     "breakout_particles.c"
     "breakout_physics.c"
     "breakout_powerups.c"
+    "breakout_profile.c"   # Frame-time profiler (PROFILE=1 ./build.sh)
+    "breakout_replay.c"    # Input recording and replay
+    "breakout_text.c"      # Shared bitmap font engine
     "breakout_ui.c"
 )
 
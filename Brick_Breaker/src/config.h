@@ -37,4 +37,11 @@
 
 #define PEACHOS_KEYBOARD_BUFFER_SIZE 1024
 
+// ADDED: 1 = show the memset/memcpy benchmark table at boot (before the menu)
+#define PEACHOS_MEMORY_BENCHMARK 0
+
+// ADDED: 1 = after a game, replay it headless, check it ends the same way
+// and offer to watch it (replay_session). 0 = clear the screen and halt.
+#define BREAKOUT_REPLAY_SESSION 0
+
 #endif
\ No newline at end of file
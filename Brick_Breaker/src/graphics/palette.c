@@ -0,0 +1,245 @@
+#include "palette.h"
+#include "vga.h"
+#include "io/io.h"
+#include "timer/timer.h"
+
+// ADDED: DAC ports (read index, write index, data)
+#define DAC_READ_INDEX  0x3C7
+#define DAC_WRITE_INDEX 0x3C8
+#define DAC_DATA        0x3C9
+
+// ADDED: Fade amount runs from 0 (base palette) to 256 (all fade color)
+#define FADE_FULL 256
+
+typedef struct {
+    uint8_t r, g, b;    // 6-bit DAC values
+} palette_entry_t;
+
+typedef struct {
+    uint8_t first;
+    uint8_t count;
+    uint32_t step_ms;
+    uint32_t last_step;
+} palette_cycle_t;
+
+// ADDED: The palette effects are applied on top of, and what the DAC holds
+static palette_entry_t palette_base[PALETTE_SIZE];
+static palette_entry_t palette_shadow[PALETTE_SIZE];
+
+// ADDED: Entries changed since the last upload (lo > hi = nothing pending)
+static int palette_dirty_lo = PALETTE_SIZE;
+static int palette_dirty_hi = -1;
+
+// ADDED: Current fade (level interpolates from fade_from to fade_to)
+static palette_entry_t fade_color = {0, 0, 0};
+static int fade_level = 0;
+static int fade_from = 0;
+static int fade_to = 0;
+static uint32_t fade_start = 0;
+static uint32_t fade_ms = 0;
+
+static palette_cycle_t palette_cycles[PALETTE_MAX_CYCLES];
+static int palette_cycle_count = 0;
+
+// ADDED: Remember that entries [lo, hi] need recomputing and uploading
+static void palette_mark(int lo, int hi)
+{
+    if (lo < palette_dirty_lo) palette_dirty_lo = lo;
+    if (hi > palette_dirty_hi) palette_dirty_hi = hi;
+}
+
+void palette_init()
+{
+    // ADDED: Start from whatever the BIOS left in the DAC
+    outb(DAC_READ_INDEX, 0);
+    for (int i = 0; i < PALETTE_SIZE; i++)
+    {
+        palette_base[i].r = insb(DAC_DATA) & 0x3F;
+        palette_base[i].g = insb(DAC_DATA) & 0x3F;
+        palette_base[i].b = insb(DAC_DATA) & 0x3F;
+        palette_shadow[i] = palette_base[i];
+    }
+
+    // ADDED: Power-up pulse ramp, bright to dim and back (cycled below)
+    static const uint8_t pulse[PALETTE_PULSE_COUNT] = {255, 224, 192, 160, 128, 160, 192, 224};
+    for (int i = 0; i < PALETTE_PULSE_COUNT; i++)
+    {
+        palette_set(PALETTE_PULSE_FIRST + i, pulse[i], pulse[i], pulse[i] / 2);
+    }
+    palette_add_cycle(PALETTE_PULSE_FIRST, PALETTE_PULSE_COUNT, 60);
+}
+
+void palette_set(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    palette_base[index].r = r >> 2;
+    palette_base[index].g = g >> 2;
+    palette_base[index].b = b >> 2;
+    palette_mark(index, index);
+}
+
+void palette_get(uint8_t index, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+    *r = palette_base[index].r << 2;
+    *g = palette_base[index].g << 2;
+    *b = palette_base[index].b << 2;
+}
+
+// ADDED: Start moving the fade level towards target
+static void palette_start_fade(int from, int target, uint32_t ms)
+{
+    fade_from = from;
+    fade_to = target;
+    fade_start = timer_get_ticks();
+    fade_ms = ms;
+
+    if (ms == 0)
+    {
+        fade_from = target;
+    }
+
+    fade_level = fade_from;
+    palette_mark(0, PALETTE_SIZE - 1);
+}
+
+void palette_fade_to(uint8_t r, uint8_t g, uint8_t b, uint32_t ms)
+{
+    fade_color.r = r >> 2;
+    fade_color.g = g >> 2;
+    fade_color.b = b >> 2;
+    palette_start_fade(fade_level, FADE_FULL, ms);
+}
+
+void palette_fade_from(uint32_t ms)
+{
+    palette_start_fade(fade_level, 0, ms);
+}
+
+void palette_flash(uint8_t r, uint8_t g, uint8_t b, uint32_t ms)
+{
+    fade_color.r = r >> 2;
+    fade_color.g = g >> 2;
+    fade_color.b = b >> 2;
+    palette_start_fade(FADE_FULL, 0, ms);
+}
+
+bool palette_fading()
+{
+    return fade_level != fade_to;
+}
+
+bool palette_add_cycle(uint8_t first, uint8_t count, uint32_t step_ms)
+{
+    if (palette_cycle_count >= PALETTE_MAX_CYCLES || count < 2)
+    {
+        return false;
+    }
+
+    palette_cycle_t* cycle = &palette_cycles[palette_cycle_count++];
+    cycle->first = first;
+    cycle->count = count;
+    cycle->step_ms = step_ms;
+    cycle->last_step = timer_get_ticks();
+    return true;
+}
+
+void palette_clear_cycles()
+{
+    palette_cycle_count = 0;
+}
+
+// ADDED: Rotate a cycle's base entries by one (last entry moves to the front)
+static void palette_step_cycle(const palette_cycle_t* cycle)
+{
+    int last = cycle->first + cycle->count - 1;
+    palette_entry_t wrap = palette_base[last];
+
+    for (int i = last; i > cycle->first; i--)
+    {
+        palette_base[i] = palette_base[i - 1];
+    }
+    palette_base[cycle->first] = wrap;
+
+    palette_mark(cycle->first, last);
+}
+
+void palette_update()
+{
+    uint32_t now = timer_get_ticks();
+
+    // ADDED: Advance the fade (any change touches every entry)
+    if (fade_level != fade_to)
+    {
+        uint32_t elapsed = now - fade_start;
+
+        if (elapsed >= fade_ms)
+        {
+            fade_level = fade_to;
+        }
+        else
+        {
+            fade_level = fade_from + (fade_to - fade_from) * (int)elapsed / (int)fade_ms;
+        }
+        palette_mark(0, PALETTE_SIZE - 1);
+    }
+
+    // ADDED: Step the cycles that are due
+    for (int i = 0; i < palette_cycle_count; i++)
+    {
+        palette_cycle_t* cycle = &palette_cycles[i];
+
+        if (now - cycle->last_step >= cycle->step_ms)
+        {
+            cycle->last_step = now;
+            palette_step_cycle(cycle);
+        }
+    }
+
+    // ADDED: Recompute the shadow entries that changed
+    for (int i = palette_dirty_lo; i <= palette_dirty_hi; i++)
+    {
+        const palette_entry_t* base = &palette_base[i];
+        palette_shadow[i].r = base->r + (((int)fade_color.r - base->r) * fade_level) / FADE_FULL;
+        palette_shadow[i].g = base->g + (((int)fade_color.g - base->g) * fade_level) / FADE_FULL;
+        palette_shadow[i].b = base->b + (((int)fade_color.b - base->b) * fade_level) / FADE_FULL;
+    }
+}
+
+void palette_upload()
+{
+    if (palette_dirty_lo > palette_dirty_hi)
+    {
+        return;
+    }
+
+    // ADDED: The DAC auto-increments its index, so one index write covers
+    // the whole changed range
+    outb(DAC_WRITE_INDEX, (uint8_t)palette_dirty_lo);
+    for (int i = palette_dirty_lo; i <= palette_dirty_hi; i++)
+    {
+        outb(DAC_DATA, palette_shadow[i].r);
+        outb(DAC_DATA, palette_shadow[i].g);
+        outb(DAC_DATA, palette_shadow[i].b);
+    }
+
+    palette_dirty_lo = PALETTE_SIZE;
+    palette_dirty_hi = -1;
+}
+
+void palette_sync()
+{
+    palette_update();
+
+    if (palette_dirty_lo <= palette_dirty_hi)
+    {
+        vga_wait_retrace();
+        palette_upload();
+    }
+}
+
+void palette_fade_wait()
+{
+    while (palette_fading())
+    {
+        palette_sync();
+    }
+}
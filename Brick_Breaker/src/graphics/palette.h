@@ -0,0 +1,55 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Palette manager. Keeps a shadow copy of the 256-entry DAC palette,
+// applies fades, flashes and color cycling to it, and sends the changed
+// entries to the DAC in one burst during vertical retrace.
+
+#define PALETTE_SIZE 256
+
+// ADDED: Color-cycling ranges that can run at the same time
+#define PALETTE_MAX_CYCLES 4
+
+// ADDED: Entries 248-255 are black in the default palette and unused by the
+// game, so they hold the pulsing ramp used for power-ups
+#define PALETTE_PULSE_FIRST 248
+#define PALETTE_PULSE_COUNT 8
+
+// ADDED: Read the current DAC palette into the shadow copy (call once,
+// after vga_init)
+void palette_init();
+
+// ADDED: Change / read a base palette entry (8-bit RGB like vga_set_palette)
+void palette_set(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
+void palette_get(uint8_t index, uint8_t* r, uint8_t* g, uint8_t* b);
+
+// ADDED: Fade the whole palette to a color, or back from it to the base
+// palette, over ms milliseconds (0 = at once)
+void palette_fade_to(uint8_t r, uint8_t g, uint8_t b, uint32_t ms);
+void palette_fade_from(uint32_t ms);
+
+// ADDED: Jump to a color and fade back to the base palette
+void palette_flash(uint8_t r, uint8_t g, uint8_t b, uint32_t ms);
+
+// ADDED: Is a fade or flash still running?
+bool palette_fading();
+
+// ADDED: Rotate entries [first, first + count) by one every step_ms
+// (returns false when all cycle slots are taken)
+bool palette_add_cycle(uint8_t first, uint8_t count, uint32_t step_ms);
+void palette_clear_cycles();
+
+// ADDED: Advance fades and cycles, then upload changes. vga_present_synced()
+// does this around its retrace wait; palette_sync() is for screens that
+// don't present every frame (it waits for retrace only if there's work).
+void palette_update();
+void palette_upload();
+void palette_sync();
+
+// ADDED: Block until the current fade has finished
+void palette_fade_wait();
+
+#endif
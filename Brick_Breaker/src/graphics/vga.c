@@ -1,9 +1,89 @@
 #include "vga.h"
 #include "io/io.h"
 #include "memory/memory.h"
+#include "timer/timer.h"
+#include "palette.h"
 
-// ADDED: Pointer to VGA memory
-static uint8_t* vga_memory = (uint8_t*)VGA_MEMORY;
+// ADDED: Off-screen back buffer (static, no heap). 16-byte aligned so
+// clears and presents can use whole SSE2 stores from the first pixel.
+static uint8_t vga_back_buffer[VGA_WIDTH * VGA_HEIGHT] __attribute__((aligned(16)));
+
+// ADDED: Pointer to the draw target - all drawing goes to the back buffer
+static uint8_t* vga_memory = vga_back_buffer;
+
+// ADDED: Bytes written to real VGA memory by the last present
+static uint32_t vga_frame_bytes = 0;
+
+// ADDED: Dirty regions waiting to be presented
+static vga_rect_t vga_dirty[VGA_MAX_DIRTY_RECTS];
+static int vga_dirty_count = 0;
+static bool vga_all_dirty = true;
+
+// ADDED: Current clip rectangle (whole screen when no clip is set)
+static const vga_rect_t vga_screen = {0, 0, VGA_WIDTH, VGA_HEIGHT};
+static vga_rect_t vga_clip = {0, 0, VGA_WIDTH, VGA_HEIGHT};
+static bool vga_clip_active = false;
+
+// ADDED: Debug outlines are drawn straight into VGA memory, so the regions
+// they covered are copied again from the back buffer on the next present
+static bool vga_dirty_debug = false;
+static vga_rect_t vga_debug_rects[VGA_MAX_DIRTY_RECTS];
+static int vga_debug_count = 0;
+
+// ADDED: Frame pacing state. The 60 Hz deadline is kept in thirds of a
+// millisecond so 16.67 ms frames don't drift (16, 17, 17, 16...).
+static vga_pacing_t vga_pacing = VGA_PACING_60HZ;
+static uint32_t vga_next_frame_x3 = 0;
+static uint32_t vga_last_present_ms = 0;
+static bool vga_paced = false;
+static uint32_t vga_missed_retraces = 0;
+static uint32_t vga_synced_frames = 0;
+
+// ADDED: Unclipped drawing into the back buffer reports its own dirty area.
+// Clipped redraw passes and off-screen targets don't.
+static inline bool vga_reports_dirty()
+{
+    return !vga_clip_active && vga_memory == vga_back_buffer;
+}
+
+// ADDED: Clip r against bounds, returns false if nothing is left
+static bool vga_intersect(vga_rect_t* r, const vga_rect_t* bounds)
+{
+    int x1 = (r->x > bounds->x) ? r->x : bounds->x;
+    int y1 = (r->y > bounds->y) ? r->y : bounds->y;
+    int x2 = (r->x + r->width < bounds->x + bounds->width) ? r->x + r->width : bounds->x + bounds->width;
+    int y2 = (r->y + r->height < bounds->y + bounds->height) ? r->y + r->height : bounds->y + bounds->height;
+    
+    if (x2 <= x1 || y2 <= y1)
+        return false;
+    
+    r->x = x1;
+    r->y = y1;
+    r->width = x2 - x1;
+    r->height = y2 - y1;
+    return true;
+}
+
+// ADDED: Grow r to also cover other
+static void vga_union(vga_rect_t* r, const vga_rect_t* other)
+{
+    int x1 = (r->x < other->x) ? r->x : other->x;
+    int y1 = (r->y < other->y) ? r->y : other->y;
+    int x2 = (r->x + r->width > other->x + other->width) ? r->x + r->width : other->x + other->width;
+    int y2 = (r->y + r->height > other->y + other->height) ? r->y + r->height : other->y + other->height;
+    
+    r->x = x1;
+    r->y = y1;
+    r->width = x2 - x1;
+    r->height = y2 - y1;
+}
+
+// ADDED: Do two rects overlap or touch?
+static bool vga_touches(const vga_rect_t* a, const vga_rect_t* b)
+{
+    return (a->x <= b->x + b->width && b->x <= a->x + a->width &&
+            a->y <= b->y + b->height && b->y <= a->y + a->height);
+}
 
 void vga_init()
 {
@@ -17,6 +97,18 @@ void vga_init()
     
     // For now, clear the screen
     vga_clear(0);
+    vga_present();
+}
+
+// ADDED: Write one pixel if it is inside the clip rect (no dirty marking)
+static inline void vga_plot(int x, int y, uint8_t color)
+{
+    if (x < vga_clip.x || x >= vga_clip.x + vga_clip.width ||
+        y < vga_clip.y || y >= vga_clip.y + vga_clip.height)
+        return;
+    
+    // ADDED: Calculate offset and write pixel
+    vga_memory[y * VGA_WIDTH + x] = color;
 }
 
 void vga_set_pixel(int x, int y, uint8_t color)
@@ -25,28 +117,29 @@ void vga_set_pixel(int x, int y, uint8_t color)
     if (x < 0 || x >= VGA_WIDTH || y < 0 || y >= VGA_HEIGHT)
         return;
     
-    // ADDED: Calculate offset and write pixel
-    vga_memory[y * VGA_WIDTH + x] = color;
+    if (vga_reports_dirty())
+    {
+        vga_mark_dirty(x, y, 1, 1);
+    }
+    
+    vga_plot(x, y, color);
 }
 
 void vga_clear(uint8_t color)
 {
-    // ADDED: Direct loop instead of memset (more reliable)
-    uint8_t* vga = (uint8_t*)0xA0000;
-    for (int i = 0; i < VGA_WIDTH * VGA_HEIGHT; i++)
+    // ADDED: memset takes the rep stosd / SSE2 path for a whole screen
+    memset(vga_memory, color, VGA_WIDTH * VGA_HEIGHT);
+    if (vga_memory == vga_back_buffer)
     {
-        vga[i] = color;
+        vga_mark_all_dirty();
     }
 }
 
 void vga_draw_frame(uint8_t* framebuffer)
 {
-    // ADDED: Direct loop instead of memcpy
-    uint8_t* vga = (uint8_t*)0xA0000;
-    for (int i = 0; i < VGA_WIDTH * VGA_HEIGHT; i++)
-    {
-        vga[i] = framebuffer[i];
-    }
+    // ADDED: One bulk copy straight into VGA memory (rep movsd / SSE2)
+    memcpy((void*)VGA_MEMORY, framebuffer, VGA_WIDTH * VGA_HEIGHT);
+    vga_frame_bytes += VGA_WIDTH * VGA_HEIGHT;
 }
 
 void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
@@ -60,16 +153,367 @@ void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
 
 void vga_fill_rect(int x, int y, int width, int height, uint8_t color)
 {
-    for (int dy = 0; dy < height; dy++)
+    // ADDED: Clip once up front instead of testing every pixel
+    vga_rect_t r = {x, y, width, height};
+    if (!vga_intersect(&r, &vga_clip))
+        return;
+    
+    if (vga_reports_dirty())
+    {
+        vga_mark_dirty(r.x, r.y, r.width, r.height);
+    }
+    
+    // ADDED: memset picks bytes / dwords / wide stores by span width
+    uint8_t* row = vga_memory + r.y * VGA_WIDTH + r.x;
+    for (int i = 0; i < r.height; i++)
+    {
+        memset(row, color, r.width);
+        row += VGA_WIDTH;
+    }
+}
+
+void vga_draw_hline(int x, int y, int width, uint8_t color)
+{
+    vga_fill_rect(x, y, width, 1, color);
+}
+
+void vga_draw_vline(int x, int y, int height, uint8_t color)
+{
+    vga_rect_t r = {x, y, 1, height};
+    if (!vga_intersect(&r, &vga_clip))
+        return;
+    
+    if (vga_reports_dirty())
+    {
+        vga_mark_dirty(r.x, r.y, 1, r.height);
+    }
+    
+    uint8_t* dst = vga_memory + r.y * VGA_WIDTH + r.x;
+    for (int i = 0; i < r.height; i++)
+    {
+        *dst = color;
+        dst += VGA_WIDTH;
+    }
+}
+
+void vga_draw_border(int x, int y, int width, int height, uint8_t color)
+{
+    if (width <= 0 || height <= 0)
+        return;
+    
+    vga_draw_hline(x, y, width, color);
+    if (height > 1)
+    {
+        vga_draw_hline(x, y + height - 1, width, color);
+    }
+    if (height > 2)
+    {
+        vga_draw_vline(x, y + 1, height - 2, color);
+        if (width > 1)
+        {
+            vga_draw_vline(x + width - 1, y + 1, height - 2, color);
+        }
+    }
+}
+
+void vga_blit(int x, int y, int width, int height, const uint8_t* pixels, int stride)
+{
+    // ADDED: Clip once, then copy whole rows
+    vga_rect_t r = {x, y, width, height};
+    if (!vga_intersect(&r, &vga_clip))
+        return;
+    
+    if (vga_reports_dirty())
     {
-        for (int dx = 0; dx < width; dx++)
+        vga_mark_dirty(r.x, r.y, r.width, r.height);
+    }
+    
+    const uint8_t* src = pixels + (r.y - y) * stride + (r.x - x);
+    uint8_t* dst = vga_memory + r.y * VGA_WIDTH + r.x;
+    for (int i = 0; i < r.height; i++)
+    {
+        memcpy(dst, src, r.width);
+        src += stride;
+        dst += VGA_WIDTH;
+    }
+}
+
+uint8_t* vga_get_back_buffer()
+{
+    return vga_back_buffer;
+}
+
+void vga_set_target(uint8_t* buffer)
+{
+    vga_memory = buffer ? buffer : vga_back_buffer;
+}
+
+// ADDED: Copy one region of the back buffer to VGA memory
+static void vga_copy_rect(const vga_rect_t* r)
+{
+    // ADDED: One memcpy per row, like vga_blit
+    for (int y = r->y; y < r->y + r->height; y++)
+    {
+        int offset = y * VGA_WIDTH + r->x;
+        memcpy((uint8_t*)VGA_MEMORY + offset, vga_back_buffer + offset, r->width);
+    }
+    vga_frame_bytes += r->width * r->height;
+}
+
+// ADDED: Draw a 1-pixel outline straight into VGA memory (debug only)
+static void vga_debug_outline(const vga_rect_t* r, uint8_t color)
+{
+    volatile uint8_t* vga = (volatile uint8_t*)VGA_MEMORY;
+    int right = r->x + r->width - 1;
+    int bottom = r->y + r->height - 1;
+    for (int x = r->x; x <= right; x++)
+    {
+        vga[r->y * VGA_WIDTH + x] = color;
+        vga[bottom * VGA_WIDTH + x] = color;
+    }
+    for (int y = r->y; y <= bottom; y++)
+    {
+        vga[y * VGA_WIDTH + r->x] = color;
+        vga[y * VGA_WIDTH + right] = color;
+    }
+}
+
+void vga_present()
+{
+    vga_frame_bytes = 0;
+    
+    if (vga_all_dirty)
+    {
+        // ADDED: One bulk copy when the whole screen changed
+        vga_draw_frame(vga_back_buffer);
+    }
+    else
+    {
+        // ADDED: Otherwise copy only the dirty regions
+        for (int i = 0; i < vga_dirty_count; i++)
+        {
+            vga_copy_rect(&vga_dirty[i]);
+        }
+        
+        // ADDED: Erase last frame's debug outlines
+        for (int i = 0; i < vga_debug_count; i++)
         {
-            int px = x + dx;
-            int py = y + dy;
-            if (px >= 0 && px < 320 && py >= 0 && py < 200)
+            vga_copy_rect(&vga_debug_rects[i]);
+        }
+    }
+    
+    vga_debug_count = 0;
+    if (vga_dirty_debug && !vga_all_dirty)
+    {
+        for (int i = 0; i < vga_dirty_count; i++)
+        {
+            vga_debug_outline(&vga_dirty[i], 13);  // Pink
+            vga_debug_rects[vga_debug_count++] = vga_dirty[i];
+        }
+    }
+    
+    vga_dirty_count = 0;
+    vga_all_dirty = false;
+}
+
+uint32_t vga_get_frame_bytes()
+{
+    return vga_frame_bytes;
+}
+
+void vga_mark_dirty(int x, int y, int width, int height)
+{
+    if (vga_all_dirty)
+        return;  // Already presenting everything
+    
+    vga_rect_t r = {x, y, width, height};
+    if (!vga_intersect(&r, &vga_screen))
+        return;
+    
+    // ADDED: Merge with every region it touches. The merged rect can reach
+    // new neighbours, so start over after each merge.
+    for (int i = 0; i < vga_dirty_count; i++)
+    {
+        if (vga_touches(&r, &vga_dirty[i]))
+        {
+            vga_union(&r, &vga_dirty[i]);
+            vga_dirty[i] = vga_dirty[--vga_dirty_count];
+            i = -1;
+        }
+    }
+    
+    // ADDED: Out of slots - collapse everything into one bounding box
+    if (vga_dirty_count == VGA_MAX_DIRTY_RECTS)
+    {
+        for (int i = 0; i < vga_dirty_count; i++)
+        {
+            vga_union(&r, &vga_dirty[i]);
+        }
+        vga_dirty_count = 0;
+    }
+    
+    vga_dirty[vga_dirty_count++] = r;
+}
+
+void vga_mark_all_dirty()
+{
+    vga_all_dirty = true;
+    vga_dirty_count = 0;
+}
+
+int vga_get_dirty_rects(const vga_rect_t** rects)
+{
+    if (vga_all_dirty)
+    {
+        *rects = &vga_screen;
+        return 1;
+    }
+    
+    *rects = vga_dirty;
+    return vga_dirty_count;
+}
+
+void vga_set_clip(const vga_rect_t* rect)
+{
+    vga_clip = *rect;
+    if (!vga_intersect(&vga_clip, &vga_screen))
+    {
+        vga_clip.width = 0;
+        vga_clip.height = 0;
+    }
+    vga_clip_active = true;
+}
+
+void vga_reset_clip()
+{
+    vga_clip = vga_screen;
+    vga_clip_active = false;
+}
+
+void vga_set_dirty_debug(bool enabled)
+{
+    vga_dirty_debug = enabled;
+}
+
+bool vga_get_dirty_debug()
+{
+    return vga_dirty_debug;
+}
+
+// ADDED: Is the display in vertical retrace right now?
+static inline bool vga_in_retrace()
+{
+    return (insb(VGA_INPUT_STATUS) & VGA_STATUS_RETRACE) != 0;
+}
+
+void vga_wait_retrace()
+{
+    // ADDED: Give up after two refreshes in case the status register isn't
+    // emulated, so a missing retrace can slow the game but never hang it
+    uint32_t start = timer_get_ticks();
+    
+    // ADDED: If we're inside a retrace, let it end first so we catch the
+    // *start* of the next one (the whole blanking interval is ours)
+    while (vga_in_retrace())
+    {
+        if (timer_get_ticks() - start > 2 * VGA_RETRACE_MS) return;
+    }
+    
+    while (!vga_in_retrace())
+    {
+        if (timer_get_ticks() - start > 2 * VGA_RETRACE_MS) return;
+    }
+}
+
+void vga_present_synced()
+{
+    uint32_t now = timer_get_ticks();
+    bool late = false;
+    
+    if (!vga_paced)
+    {
+        // ADDED: First synced frame - start the schedule from here
+        vga_next_frame_x3 = now * 3;
+        vga_last_present_ms = now;
+        vga_paced = true;
+    }
+    
+    if (vga_pacing == VGA_PACING_60HZ)
+    {
+        // ADDED: Late by more than a whole refresh = this frame's slot is gone
+        uint32_t behind_x3 = now * 3 - vga_next_frame_x3;
+        if ((int32_t)behind_x3 > VGA_RETRACE_MS * 3)
+        {
+            late = true;
+            
+            // ADDED: Way behind (debugger, disk load...) - resync instead of
+            // rushing out a burst of catch-up frames
+            if ((int32_t)behind_x3 > 50 * 3)
             {
-                vga_set_pixel(px, py, color);
+                vga_next_frame_x3 = now * 3;
             }
         }
+        
+        while ((int32_t)(timer_get_ticks() * 3 - vga_next_frame_x3) < 0)
+        {
+            // Wait for this frame's 60 Hz slot
+        }
+        vga_next_frame_x3 += 50;  // 1000 / 60 ms, in thirds of a ms
+    }
+    else
+    {
+        // ADDED: Locked to the refresh, more than one refresh since the last
+        // present means at least one retrace went by without a new frame
+        if (now - vga_last_present_ms > VGA_RETRACE_MS + VGA_RETRACE_MS / 2)
+        {
+            late = true;
+        }
     }
-}
\ No newline at end of file
+    
+    // ADDED: Palette changes are computed up front and go out first, while
+    // the beam is off, so color and pixel changes land on the same frame
+    palette_update();
+    vga_wait_retrace();
+    palette_upload();
+    vga_present();
+    
+    // ADDED: Copy ran past the blanking interval = visible tear
+    if (!vga_in_retrace())
+    {
+        late = true;
+    }
+    
+    if (late)
+    {
+        vga_missed_retraces++;
+    }
+    
+    vga_synced_frames++;
+    vga_last_present_ms = timer_get_ticks();
+}
+
+void vga_set_pacing(vga_pacing_t pacing)
+{
+    vga_pacing = pacing;
+    vga_reset_pacing();  // ADDED: Restart the schedule under the new policy
+}
+
+void vga_reset_pacing()
+{
+    vga_paced = false;
+}
+
+vga_pacing_t vga_get_pacing()
+{
+    return vga_pacing;
+}
+
+uint32_t vga_get_missed_retraces()
+{
+    return vga_missed_retraces;
+}
+
+uint32_t vga_get_synced_frames()
+{
+    return vga_synced_frames;
+}
@@ -9,13 +9,35 @@
 #define VGA_HEIGHT 200
 #define VGA_MEMORY 0xA0000
 
+// ADDED: Max separate dirty regions tracked per frame (more collapse into one)
+#define VGA_MAX_DIRTY_RECTS 32
+
+// ADDED: VGA input status register - bit 3 is set during vertical retrace
+#define VGA_INPUT_STATUS 0x3DA
+#define VGA_STATUS_RETRACE 0x08
+
+// ADDED: Mode 13h refreshes at ~70 Hz, so one retrace every ~14.3 ms
+#define VGA_RETRACE_MS 14
+
+// ADDED: How vga_present_synced() paces frames
+typedef enum {
+    VGA_PACING_VSYNC,   // One frame per vertical retrace (70 Hz)
+    VGA_PACING_60HZ     // Fixed 60 Hz, each frame shown at the next retrace
+} vga_pacing_t;
+
+// ADDED: Screen rectangle (used for dirty regions and clipping)
+typedef struct {
+    int x, y;
+    int width, height;
+} vga_rect_t;
+
 // ADDED: Initialize VGA Mode 13h (320x200, 256 colors)
 void vga_init();
 
-// ADDED: Set a single pixel
+// ADDED: Set a single pixel (in the back buffer)
 void vga_set_pixel(int x, int y, uint8_t color);
 
-// ADDED: Clear screen to a color
+// ADDED: Clear the back buffer to a color
 void vga_clear(uint8_t color);
 
 // ADDED: Draw entire framebuffer (for DoomGeneric)
@@ -24,6 +46,66 @@ void vga_draw_frame(uint8_t* framebuffer);
 // ADDED: Set VGA palette entry
 void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
 
+// ADDED: Span primitives - the rectangle is clipped once, then each row is
+// filled with one memset
 void vga_fill_rect(int x, int y, int width, int height, uint8_t color);
+void vga_draw_hline(int x, int y, int width, uint8_t color);
+void vga_draw_vline(int x, int y, int height, uint8_t color);
+
+// ADDED: Hollow rectangle (1-pixel border)
+void vga_draw_border(int x, int y, int width, int height, uint8_t color);
+
+// ADDED: Copy an opaque sprite (rows of width pixels, stride bytes apart)
+void vga_blit(int x, int y, int width, int height, const uint8_t* pixels, int stride);
+
+// ADDED: Off-screen back buffer. Every vga_* draw call renders into it and
+// nothing reaches the screen until vga_present() copies it to VGA memory.
+uint8_t* vga_get_back_buffer();
+
+// ADDED: Send vga_* drawing to another 320x200 buffer (0 = back buffer again).
+// Off-screen targets never report dirty regions.
+void vga_set_target(uint8_t* buffer);
+
+// ADDED: Copy the dirty parts of the back buffer to VGA memory (call once per frame)
+void vga_present();
+
+// ADDED: Wait for the frame's time slot, then for the start of vertical
+// retrace, and present inside the blanking interval (no tearing)
+void vga_present_synced();
+
+// ADDED: Busy-wait until the next vertical retrace starts
+void vga_wait_retrace();
+
+// ADDED: Frame pacing policy (default: fixed 60 Hz)
+void vga_set_pacing(vga_pacing_t pacing);
+vga_pacing_t vga_get_pacing();
+
+// ADDED: Restart the frame schedule (after a pause or a one-shot screen) so
+// the gap isn't counted as missed frames
+void vga_reset_pacing();
+
+// ADDED: Frames that came late or didn't finish presenting inside the
+// blanking interval, out of all synced presents
+uint32_t vga_get_missed_retraces();
+uint32_t vga_get_synced_frames();
+
+// ADDED: Dirty-rectangle tracking. Drawing outside a clipped redraw pass
+// reports itself automatically; game code reports state changes directly.
+void vga_mark_dirty(int x, int y, int width, int height);
+void vga_mark_all_dirty();
+
+// ADDED: Get this frame's merged dirty regions (returns how many)
+int vga_get_dirty_rects(const vga_rect_t** rects);
+
+// ADDED: Restrict vga_* drawing to a rectangle (used to redraw one dirty region)
+void vga_set_clip(const vga_rect_t* rect);
+void vga_reset_clip();
+
+// ADDED: Debug mode - outline presented dirty regions on screen
+void vga_set_dirty_debug(bool enabled);
+bool vga_get_dirty_debug();
+
+// ADDED: Bytes written to VGA memory by the last vga_present()
+uint32_t vga_get_frame_bytes();
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,25 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Hosted build (make host): the game compiled as a normal Linux program.
+ * host_stubs.c stands in for the hardware drivers, host_main.c drives the
+ * game. This is the glue between the two.
+ */
+
+// Simulated frame length the stub present waits for (60 Hz pacing)
+#define HOST_FRAME_US 16667
+
+// Queue a key event for the stub keyboard
+void host_key_push(uint8_t scancode, bool pressed);
+
+// Called by the stub keyboard when its queue is empty (the input script)
+void host_script_poll();
+
+// Virtual clock in milliseconds (the stub timer)
+uint32_t host_clock_ms();
+
+#endif // HOST_H
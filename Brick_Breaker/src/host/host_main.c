@@ -0,0 +1,315 @@
+/*
+ * host_main.c - Hosted driver: record and replay games on Linux
+ *
+ * Usage: breakout_host [-p players] [-s seed] [-f frames] [-n runs]
+ *                      [-m classic|storm] [-c] [-r log] [-w log]
+ *
+ * Unless a log is loaded with -r, an autopilot first plays one game through
+ * the normal game loop (breakout_run) while it is recorded, exactly as the
+ * kernel records a human game. It ends when every player is done or after
+ * -f frames. -w saves that log. -m storm plays a ball storm instead (the
+ * many-balls stress test), and -c has the autopilot press B at the start,
+ * turning balls bouncing off each other the other way.
+ *
+ * The log is then replayed headless -n times, as fast as the host allows.
+ * That is the update half of the game on its own - no drawing, no waiting -
+ * so it is what to run under perf or cachegrind. Each run prints its
+ * frames per second and checks the final game state against the recording.
+ *
+ * Exit status: 0 if every replay matched, 1 if one diverged, 2 on errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "breakout/breakout.h"
+#include "breakout/breakout_events.h"
+#include "breakout/breakout_replay.h"
+#include "host.h"
+
+extern game_state_t game;
+
+/* ============================================================================
+ * AUTOPILOT
+ * ============================================================================
+ * The input script for recording: once per 60 Hz tick it taps the paddle
+ * towards the lowest falling ball and fires when it has lasers. Releases
+ * aren't sent - the game only acts on presses.
+ */
+
+static bool autopilot_on = false;
+static uint32_t autopilot_frames = 36000;   // Ten minutes of play
+static uint32_t autopilot_tick = 0;
+static bool autopilot_toggle_collisions = false;
+
+/*
+ * autopilot_target - X the paddle centre should be under, or -1 if no ball
+ */
+static int autopilot_target(uint32_t tick)
+{
+    const ball_t* best = 0;
+    const ball_t* ball;
+
+    POOL_FOR_EACH(&game.balls, ball)
+    {
+        // A falling ball beats a rising one, then the lower the better
+        if (!best || (ball->dy > 0 && best->dy <= 0) ||
+            ((ball->dy > 0) == (best->dy > 0) && ball->y > best->y))
+        {
+            best = ball;
+        }
+    }
+
+    if (!best)
+    {
+        return -1;
+    }
+
+    // Hit the ball off-centre by an amount that drifts over time, so it
+    // can't settle into a loop that never reaches the last bricks
+    int offset = (int)(tick / 300 % 5) * 5 - 10;
+    return FIXED_TO_INT(best->x) + BALL_SIZE / 2 + offset;
+}
+
+void host_script_poll()
+{
+    if (!autopilot_on)
+    {
+        return;
+    }
+
+    uint32_t tick = game.sim_steps / SIM_SUBSTEPS;
+
+    if (game.all_players_done || tick >= autopilot_frames)
+    {
+        host_key_push(0x01, true);    // ESC ends the game
+        autopilot_on = false;
+        return;
+    }
+
+    // Timed screens don't advance the simulation, so nothing is pressed
+    // there and they run their course
+    if (tick == autopilot_tick)
+    {
+        return;
+    }
+    autopilot_tick = tick;
+
+    if (autopilot_toggle_collisions)
+    {
+        host_key_push(0x30, true);    // B (once play has started)
+        autopilot_toggle_collisions = false;
+    }
+
+    const player_t* player = &game.players[game.current_player];
+    int target = autopilot_target(tick);
+    int centre = player->paddle_x + player->paddle_width / 2;
+
+    if (target >= 0 && centre < target - PADDLE_SPEED)
+    {
+        host_key_push(0x4D, true);    // Right
+    }
+    else if (target >= 0 && centre > target + PADDLE_SPEED)
+    {
+        host_key_push(0x4B, true);    // Left
+    }
+
+    if (player->has_laser && tick % 4 == 0)
+    {
+        host_key_push(0x1D, true);    // Fire
+    }
+}
+
+/* ============================================================================
+ * LOG FILES
+ * ============================================================================
+ */
+
+static bool load_log(const char* path)
+{
+    static uint8_t data[REPLAY_MAX_BYTES];
+    FILE* file = fopen(path, "rb");
+
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    size_t size = fread(data, 1, sizeof(data), file);
+    fclose(file);
+
+    if (!replay_load(data, (uint32_t)size))
+    {
+        fprintf(stderr, "%s: not a replay log\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool save_log(const char* path)
+{
+    uint32_t size;
+    const uint8_t* data = replay_data(&size);
+    FILE* file = fopen(path, "wb");
+
+    if (!file || fwrite(data, 1, size, file) != size)
+    {
+        perror(path);
+        if (file)
+        {
+            fclose(file);
+        }
+        return false;
+    }
+
+    fclose(file);
+    return true;
+}
+
+/* ============================================================================
+ * RUNS
+ * ============================================================================
+ */
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void print_scores()
+{
+    printf(" score");
+    for (int p = 0; p < game.num_players; p++)
+    {
+        printf(" %d", game.players[p].score);
+    }
+}
+
+/*
+ * print_pools - Peak use and refused spawns of each object pool, and events
+ * that didn't fit in the event queue
+ */
+static void print_pools()
+{
+    printf("pools: balls %d/%d peak, %d refused; power-ups %d/%d peak, %d refused",
+           game.balls.high_water, MAX_BALLS, game.balls.spawn_failures,
+           game.powerups.high_water, MAX_POWERUPS, game.powerups.spawn_failures);
+
+    for (int p = 0; p < game.num_players; p++)
+    {
+        const laser_pool_t* lasers = &game.players[p].lasers;
+        printf("; P%d lasers %d/%d peak, %d refused",
+               p + 1, lasers->high_water, MAX_LASERS, lasers->spawn_failures);
+    }
+    printf("; events %u dropped\n", events_dropped());
+}
+
+/*
+ * record_game - Let the autopilot play one recorded game
+ */
+static void record_game(uint32_t seed, int num_players, game_mode_t mode)
+{
+    uint32_t size;
+    double start = now_seconds();
+
+    replay_record_start(seed, num_players, 0, mode);
+    autopilot_on = true;
+    autopilot_tick = 0;
+    breakout_run();
+    replay_record_finish();
+
+    double seconds = now_seconds() - start;
+    replay_data(&size);
+
+    printf("recorded: %u frames, level %d,", game.sim_steps / SIM_SUBSTEPS, game.level + 1);
+    print_scores();
+    printf(", %u log bytes, %.1f ms\n", size, seconds * 1000);
+    print_pools();
+}
+
+/*
+ * replay_game - Replay the log headless once; returns whether it matched
+ */
+static bool replay_game(int run)
+{
+    replay_report_t report;
+
+    if (!replay_play_start(true))
+    {
+        fprintf(stderr, "replay: log was recorded at a different SIM_RATE\n");
+        exit(2);
+    }
+
+    double start = now_seconds();
+    breakout_run();
+    double seconds = now_seconds() - start;
+
+    replay_play_finish(&report);
+
+    bool match = report.has_expected && report.checksum == report.expected;
+    printf("replay %d: %u frames (%u steps) in %.2f ms, %.2f M frames/s, checksum %08X %s\n",
+           run, report.frames, report.steps, seconds * 1000,
+           report.frames / seconds / 1e6, report.checksum,
+           !report.has_expected ? "(log incomplete)" : match ? "MATCH" : "DIVERGED");
+    return match;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t seed = 1;
+    int num_players = 1;
+    int runs = 1;
+    const char* read_path = 0;
+    const char* write_path = 0;
+    game_mode_t mode = GAME_MODE_CLASSIC;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:s:f:n:m:cr:w:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p': num_players = atoi(optarg); break;
+            case 's': seed = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'f': autopilot_frames = (uint32_t)strtoul(optarg, 0, 0); break;
+            case 'n': runs = atoi(optarg); break;
+            case 'm': mode = (strcmp(optarg, "storm") == 0) ? GAME_MODE_STORM : GAME_MODE_CLASSIC; break;
+            case 'c': autopilot_toggle_collisions = true; break;
+            case 'r': read_path = optarg; break;
+            case 'w': write_path = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-p players] [-s seed] [-f frames] [-n runs] "
+                                "[-m classic|storm] [-c] [-r log] [-w log]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (read_path)
+    {
+        if (!load_log(read_path))
+        {
+            return 2;
+        }
+    }
+    else
+    {
+        record_game(seed, num_players, mode);
+    }
+
+    if (write_path && !save_log(write_path))
+    {
+        return 2;
+    }
+
+    bool all_match = true;
+    for (int run = 1; run <= runs; run++)
+    {
+        all_match &= replay_game(run);
+    }
+
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ * host_stubs.c - Stand-in hardware for the hosted build
+ *
+ * The game files are compiled unchanged; everything they would normally
+ * get from the kernel drivers comes from here instead:
+ * - VGA and palette calls do nothing (nothing is shown)
+ * - Speaker tones and music are dropped (nothing is heard)
+ * - The keyboard hands out events queued by the input script
+ * - The timer is a virtual clock, so runs don't depend on the host's speed
+ *
+ * The virtual clock moves on by a millisecond every time it is read, which
+ * lets loops that wait on it (timed screens) finish. Presenting a synced
+ * frame moves it on to the start of the next 60 Hz frame, as the real
+ * frame pacing would.
+ */
+
+#include "keyboard/keyboard.h"
+#include "graphics/vga.h"
+#include "graphics/palette.h"
+#include "timer/timer.h"
+#include "sound/speaker.h"
+#include "sound/music.h"
+#include "sound/opl2.h"
+#include "host.h"
+
+/* ============================================================================
+ * TIMER
+ * ============================================================================
+ */
+
+static uint64_t clock_us = 0;
+
+uint32_t timer_get_ticks()
+{
+    clock_us += 1000;
+    return (uint32_t)(clock_us / 1000);
+}
+
+void timer_wait(uint32_t ms)
+{
+    clock_us += (uint64_t)ms * 1000;
+}
+
+uint32_t host_clock_ms()
+{
+    return (uint32_t)(clock_us / 1000);
+}
+
+/* ============================================================================
+ * KEYBOARD
+ * ============================================================================
+ */
+
+#define KEY_QUEUE_SIZE 64   // Power of two
+
+static key_event_t key_queue[KEY_QUEUE_SIZE];
+static uint32_t key_head = 0;
+static uint32_t key_tail = 0;
+
+void host_key_push(uint8_t scancode, bool pressed)
+{
+    if (key_tail - key_head == KEY_QUEUE_SIZE)
+    {
+        return;   // Full - drop it, like the real keyboard buffer
+    }
+
+    key_event_t* event = &key_queue[key_tail++ & (KEY_QUEUE_SIZE - 1)];
+    event->scancode = scancode;
+    event->ascii = 0;
+    event->pressed = pressed;
+}
+
+void keyboard_init()
+{
+    key_head = key_tail = 0;
+}
+
+bool keyboard_get_event(key_event_t* event)
+{
+    if (key_head == key_tail)
+    {
+        host_script_poll();
+    }
+
+    if (key_head == key_tail)
+    {
+        return false;
+    }
+
+    *event = key_queue[key_head++ & (KEY_QUEUE_SIZE - 1)];
+    return true;
+}
+
+/* ============================================================================
+ * PC SPEAKER
+ * ============================================================================
+ */
+
+void speaker_play(uint16_t frequency, uint16_t duration_ms, speaker_priority_t priority) { }
+void speaker_stop() { }
+
+// No disk and nothing to play on: songs come back empty
+int music_parse(music_song_t* song, const char* text, uint32_t length)
+{
+    song->count = 0;
+    return 0;
+}
+
+int music_load(music_song_t* song, const char* path)
+{
+    song->count = 0;
+    return -1;
+}
+
+void music_play(const music_song_t* song) { }
+void music_pause(bool paused) { }
+
+void opl2_update() { }
+void opl2_silence() { }
+
+/* ============================================================================
+ * VGA
+ * ============================================================================
+ */
+
+void vga_set_pixel(int x, int y, uint8_t color) { }
+void vga_clear(uint8_t color) { }
+void vga_fill_rect(int x, int y, int width, int height, uint8_t color) { }
+void vga_draw_hline(int x, int y, int width, uint8_t color) { }
+void vga_draw_vline(int x, int y, int height, uint8_t color) { }
+void vga_draw_border(int x, int y, int width, int height, uint8_t color) { }
+void vga_blit(int x, int y, int width, int height, const uint8_t* pixels, int stride) { }
+void vga_set_target(uint8_t* buffer) { }
+void vga_mark_dirty(int x, int y, int width, int height) { }
+void vga_mark_all_dirty() { }
+void vga_set_clip(const vga_rect_t* rect) { }
+void vga_reset_clip() { }
+void vga_present() { }
+void vga_reset_pacing() { }
+
+int vga_get_dirty_rects(const vga_rect_t** rects)
+{
+    *rects = 0;
+    return 0;
+}
+
+/*
+ * vga_present_synced - Skip the virtual clock to the next frame slot
+ */
+void vga_present_synced()
+{
+    clock_us = (clock_us / HOST_FRAME_US + 1) * HOST_FRAME_US;
+}
+
+static bool dirty_debug = false;
+static vga_pacing_t pacing = VGA_PACING_60HZ;
+
+void vga_set_dirty_debug(bool enabled)
+{
+    dirty_debug = enabled;
+}
+
+bool vga_get_dirty_debug()
+{
+    return dirty_debug;
+}
+
+void vga_set_pacing(vga_pacing_t new_pacing)
+{
+    pacing = new_pacing;
+}
+
+vga_pacing_t vga_get_pacing()
+{
+    return pacing;
+}
+
+/* ============================================================================
+ * PALETTE
+ * ============================================================================
+ */
+
+void palette_fade_to(uint8_t r, uint8_t g, uint8_t b, uint32_t ms) { }
+void palette_fade_from(uint32_t ms) { }
+void palette_flash(uint8_t r, uint8_t g, uint8_t b, uint32_t ms) { }
+void palette_fade_wait() { }
+void palette_sync() { }
@@ -24,9 +24,14 @@ idt_load:
     ret
 
 
+; ADDED: Every stub clears the direction flag after saving the registers:
+; an interrupt can arrive in the middle of memmove's backwards copy (std),
+; and C code expects DF = 0. XMM registers are not saved here; memcpy and
+; memset see IF clear in a handler and skip their SSE2 paths (memory.c).
 int21h:
     cli
     pushad
+    cld
     call int21h_handler
     popad
     iret
@@ -34,6 +39,7 @@ int21h:
 no_interrupt:
     cli
     pushad
+    cld
     call no_interrupt_handler
     mov al, 0x20
     out 0x20, al
@@ -47,12 +53,27 @@ global irq0_handler
 irq0_handler:
     cli
     pushad
+    cld
     call timer_handler
     mov al, 0x20
     out 0x20, al
     popad
     iret
 
+; ADDED: Sound Blaster 16 interrupt (IRQ5 = interrupt 0x25)
+extern sb16_irq_handler
+
+global irq5_handler
+irq5_handler:
+    cli
+    pushad
+    cld
+    call sb16_irq_handler
+    mov al, 0x20
+    out 0x20, al
+    popad
+    iret
+
 global exception_halt
 exception_halt:
     cli
@@ -10,6 +10,7 @@ extern void idt_load(struct idtr_desc* ptr);
 extern void int21h();
 extern void no_interrupt();
 extern void irq0_handler();  // ADDED: Timer handler from idt.asm
+extern void irq5_handler();  // ADDED: Sound Blaster handler from idt.asm
 extern void keyboard_handler();  // ADDED: From keyboard.c
 extern void exception_halt();
 
@@ -64,6 +65,7 @@ void idt_init(void)
     idt_set(0, idt_zero);
     idt_set(0x20, irq0_handler);
     idt_set(0x21, int21h);
+    idt_set(0x25, irq5_handler);  // ADDED: Unmasked by sb16_init
     
     idt_load(&idtr_descriptor);
 }
\ No newline at end of file
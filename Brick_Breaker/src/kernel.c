@@ -5,6 +5,7 @@
 #include "memory/heap/kheap.h"
 #include "memory/paging/paging.h"
 #include "memory/memory.h"
+#include "memory/benchmark.h"
 #include "string/string.h"
 #include "fs/file.h"
 #include "disk/disk.h"
@@ -16,8 +17,14 @@
 #include "timer/timer.h"  // ADDED: Timer functions
 #include "keyboard/keyboard.h"  // ADDED
 #include "graphics/vga.h" // ADDED
+#include "graphics/palette.h"
+#include "sound/pcm.h"
+#include "sound/sb16.h"
+#include "sound/opl2.h"
 #include "breakout/breakout.h"
 #include "breakout/breakout_menu.h"
+#include "breakout/breakout_text.h"
+#include "breakout/breakout_replay.h"
 
 uint16_t* video_mem = 0;
 uint16_t terminal_row = 0;
@@ -125,10 +132,20 @@ void print_number(uint32_t num)
 void* wad_data = 0;
 unsigned int wad_size_rounded = 0;
 
+// ADDED: Turn the whole screen one of the status colors below by fading
+// the palette to it - no pixels are repainted
+static void show_status(uint8_t color)
+{
+    uint8_t r, g, b;
+    palette_get(color, &r, &g, &b);
+    palette_fade_to(r, g, b, 0);
+    palette_sync();
+}
+
 static void load_wad_to_ram(void)
 {
     // Color 14 = yellow: starting WAD load
-    vga_clear(14);
+    show_status(14);
 
     size_t wad_sectors = (WAD_BYTES + 511) / 512;
     wad_size_rounded = wad_sectors * 512;
@@ -136,14 +153,14 @@ static void load_wad_to_ram(void)
     wad_data = kmalloc(wad_size_rounded);
     if (!wad_data)
     {
-        vga_clear(4); // red = alloc fail
+        show_status(4); // red = alloc fail
         while (1) {}
     }
 
     struct disk_stream* stream = diskstreamer_new(0);
     if (!stream)
     {
-        vga_clear(5); // magenta = streamer fail
+        show_status(5); // magenta = streamer fail
         while (1) {}
     }
 
@@ -154,27 +171,75 @@ static void load_wad_to_ram(void)
 
     if (res < 0)
     {
-        vga_clear(1); // blue = read fail
+        show_status(1); // blue = read fail
         while (1) {}
     }
 
     char* p = (char*)wad_data;
     if (!(p[0]=='I' && p[1]=='W' && p[2]=='A' && p[3]=='D'))
     {
-        vga_clear(6); // brown = bad header
+        show_status(6); // brown = bad header
         while (1) {}
     }
 
     // Green = WAD OK
-    vga_clear(2);
+    show_status(2);
 }
 
 
+#if PEACHOS_MEMORY_BENCHMARK
+// ADDED: Run the memory benchmark and show bytes per 100 cycles for each
+// memset/memcpy variant (rows) at each block size (columns)
+static void show_memory_benchmark()
+{
+    struct memory_bench_result results[MEMORY_BENCH_VARIANTS];
+
+    vga_clear(0);
+    text_draw(8, 4, "BYTES PER 100 CYCLES", TEXT_FONT_LARGE, 15);
+    vga_present();
+
+    if (memory_benchmark(results) < 0)
+    {
+        text_draw(8, 40, "NO MEMORY", TEXT_FONT_LARGE, 4);
+        vga_present();
+        return;
+    }
+
+    for (int s = 0; s < MEMORY_BENCH_SIZES; s++)
+    {
+        text_draw_number(130 + s * 56, 24, results[0].sizes[s], 8);
+    }
+
+    for (int v = 0; v < MEMORY_BENCH_VARIANTS; v++)
+    {
+        int y = 38 + v * 16;
+        uint8_t color = (v < MEMORY_BENCH_COPY_BYTES) ? 14 : 11;
+
+        text_draw(8, y, results[v].name, TEXT_FONT_LARGE, color);
+        for (int s = 0; s < MEMORY_BENCH_SIZES; s++)
+        {
+            text_draw_number(130 + s * 56, y + 2, results[v].bytes_per_100_cycles[s], color);
+        }
+    }
+
+    text_draw(8, 176, "PRESS ANY KEY", TEXT_FONT_LARGE, 8);
+    vga_present();
+
+    key_event_t event;
+    while (!keyboard_get_event(&event) || !event.pressed)
+    {
+    }
+}
+#endif
+
 void kernel_main()
 {
     // DON'T initialize terminal - we're in graphics mode now!
     // terminal_initialize();  // REMOVE THIS
     
+    // ADDED: Turn on SSE2 (if present) before anything calls memset/memcpy
+    memory_init();
+    
     // Setup GDT (no visual output)
     memset(gdt_real, 0x00, sizeof(gdt_real));
     gdt_structured_to_gdt(gdt_real, gdt_structured, PEACHOS_TOTAL_GDT_SEGMENTS);
@@ -202,27 +267,61 @@ void kernel_main()
     
     // Enable interrupts
     enable_interrupts();
+
+    // ADDED: Sound Blaster if there is one; otherwise the PC speaker
+    // (PCM if built with it, plain tones if not)
+    if (!sb16_init(16))
+    {
+#ifdef SOUND_PCM
+        // ADDED: Sound as PCM: IRQ0 moves to the sample rate, ticks carry on
+        pcm_init();
+#endif
+    }
+
+    // ADDED: Music on the AdLib if there is one (the effects stay above)
+    opl2_init();
     
     // ADDED: Initialize VGA (already in mode 13h from boot)
     vga_init();
+    
+    // Shadow palette for fades, flashes and color cycling
+    palette_init();
+    
+    // Build the font atlas used by the menu and game UI
+    text_init();
+
+#if PEACHOS_MEMORY_BENCHMARK
+    show_memory_benchmark();
+#endif
 
     int num_players = menu_run();
 
     if (num_players == 0){
         vga_clear(0);
+        vga_present();
 
         while(1) {}
     }
 
-    breakout_init(num_players);
+    // ADDED: Set up and record the game (seeded from the clock) so it can be
+    // replayed
+    replay_record_start(timer_get_ticks(), num_players, 0,
+                        menu_ball_storm() ? GAME_MODE_STORM : GAME_MODE_CLASSIC);
 
     breakout_run();
+    replay_record_finish();
+
+#if BREAKOUT_REPLAY_SESSION
+    // ADDED: Replay it headless, check it ends the same way, offer to watch
+    replay_session();
+#endif
 
     // ------------------------------------------------------------------------
     // 4. GAME ENDED
     // ------------------------------------------------------------------------
     // User pressed ESC, game loop exited
     vga_clear(0);
+    vga_present();
     
     while(1) {}
     
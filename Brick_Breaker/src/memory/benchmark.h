@@ -0,0 +1,35 @@
+#ifndef MEMORY_BENCHMARK_H
+#define MEMORY_BENCHMARK_H
+
+#include <stdint.h>
+
+// ADDED: memset/memcpy strategies measured by memory_benchmark()
+enum
+{
+    MEMORY_BENCH_SET_BYTES,
+    MEMORY_BENCH_SET_DWORDS,
+    MEMORY_BENCH_SET_REP,
+    MEMORY_BENCH_SET_SSE2,
+    MEMORY_BENCH_COPY_BYTES,
+    MEMORY_BENCH_COPY_DWORDS,
+    MEMORY_BENCH_COPY_REP,
+    MEMORY_BENCH_COPY_SSE2,
+    MEMORY_BENCH_VARIANTS
+};
+
+// ADDED: Block sizes each variant is timed at
+#define MEMORY_BENCH_SIZES 4
+
+struct memory_bench_result
+{
+    const char* name;
+    uint32_t sizes[MEMORY_BENCH_SIZES];
+    // ADDED: Bytes per 100 cycles (bytes/cycle with two decimals)
+    uint32_t bytes_per_100_cycles[MEMORY_BENCH_SIZES];
+};
+
+// ADDED: Time every variant at every size with RDTSC (needs the heap for
+// its buffers). Returns 0 on success, -ENOMEM if the buffers can't be had.
+int memory_benchmark(struct memory_bench_result results[MEMORY_BENCH_VARIANTS]);
+
+#endif
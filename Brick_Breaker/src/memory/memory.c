@@ -1,6 +1,60 @@
 #include "memory.h"
+#include <stdint.h>
 
-void* memset(void* ptr, int c, size_t size)
+// ADDED: Below this many bytes a plain byte loop wins (no setup at all)
+#define MEMORY_SMALL 16
+
+// ADDED: From here on the string instructions / SSE2 beat a dword loop
+#define MEMORY_LARGE 256
+
+// ADDED: Set by memory_init() once SSE2 is detected and enabled
+static int memory_sse2 = 0;
+
+// ADDED: Only use the SSE2 paths with interrupts enabled. Every interrupt
+// stub runs with IF clear and saves no XMM registers, so this keeps any
+// handler from clobbering an interrupted SSE2 copy.
+static inline int memory_sse2_usable()
+{
+    uint32_t flags;
+    __asm__ volatile ("pushfl; popl %0" : "=r"(flags));
+    return memory_sse2 && (flags & (1u << 9));
+}
+
+void memory_init()
+{
+    // ADDED: CPUID leaf 1, EDX bit 26 = SSE2
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    if (!(edx & (1 << 26)))
+    {
+        return;
+    }
+
+    // ADDED: SSE instructions fault until the OS says it saves their state:
+    // CR0.EM off, CR0.MP on, CR4.OSFXSR and CR4.OSXMMEXCPT on. Nothing
+    // saves XMM registers on an interrupt; memset/memcpy fall back to rep
+    // while interrupts are off (see memory_sse2_usable).
+    uint32_t cr0, cr4;
+    __asm__ volatile ("mov %%cr0, %0" : "=r"(cr0));
+    cr0 &= ~(1u << 2);
+    cr0 |= (1u << 1);
+    __asm__ volatile ("mov %0, %%cr0" :: "r"(cr0));
+
+    __asm__ volatile ("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1u << 9) | (1u << 10);
+    __asm__ volatile ("mov %0, %%cr4" :: "r"(cr4));
+
+    memory_sse2 = 1;
+}
+
+int memory_has_sse2()
+{
+    return memory_sse2;
+}
+
+// ADDED: ---- memset variants ----
+
+void* memset_bytes(void* ptr, int c, size_t size)
 {
     char* c_ptr = (char*) ptr;
     for (size_t i = 0; i < size; i++)  // FIXED: Use size_t instead of int
@@ -10,6 +64,110 @@ void* memset(void* ptr, int c, size_t size)
     return ptr;
 }
 
+void* memset_dwords(void* ptr, int c, size_t size)
+{
+    uint8_t* d = (uint8_t*)ptr;
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+
+    // ADDED: Bytes up to a dword boundary, then 4 at a time, then the tail
+    while (size > 0 && ((uintptr_t)d & 3))
+    {
+        *d++ = (uint8_t)c;
+        size--;
+    }
+
+    uint32_t* d32 = (uint32_t*)d;
+    for (size_t i = 0; i < size / 4; i++)
+    {
+        d32[i] = pattern;
+    }
+
+    d += size & ~(size_t)3;
+    for (size_t i = 0; i < (size & 3); i++)
+    {
+        d[i] = (uint8_t)c;
+    }
+    return ptr;
+}
+
+void* memset_rep(void* ptr, int c, size_t size)
+{
+    uint8_t* d = (uint8_t*)ptr;
+    uint32_t pattern = (uint8_t)c * 0x01010101u;
+
+    while (size > 0 && ((uintptr_t)d & 3))
+    {
+        *d++ = (uint8_t)c;
+        size--;
+    }
+
+    // ADDED: rep stosd stores EAX to [EDI], ECX times
+    size_t count = size / 4;
+    __asm__ volatile ("rep stosl" : "+D"(d), "+c"(count) : "a"(pattern) : "memory");
+
+    for (size_t i = 0; i < (size & 3); i++)
+    {
+        d[i] = (uint8_t)c;
+    }
+    return ptr;
+}
+
+void* memset_sse2(void* ptr, int c, size_t size)
+{
+    if (!memory_sse2)
+    {
+        return memset_rep(ptr, c, size);
+    }
+
+    uint8_t* d = (uint8_t*)ptr;
+
+    while (size > 0 && ((uintptr_t)d & 15))
+    {
+        *d++ = (uint8_t)c;
+        size--;
+    }
+
+    // ADDED: 64 bytes per iteration with aligned 16-byte stores. XMM registers
+    // can't be listed as clobbers without -msse, but the compiler never uses
+    // them in this kernel, so the asm owns them.
+    size_t blocks = size / 64;
+    if (blocks > 0)
+    {
+        uint32_t pattern = (uint8_t)c * 0x01010101u;
+        __asm__ volatile (
+            "movd %2, %%xmm0\n\t"
+            "pshufd $0, %%xmm0, %%xmm0\n\t"
+            "1:\n\t"
+            "movdqa %%xmm0, (%0)\n\t"
+            "movdqa %%xmm0, 16(%0)\n\t"
+            "movdqa %%xmm0, 32(%0)\n\t"
+            "movdqa %%xmm0, 48(%0)\n\t"
+            "add $64, %0\n\t"
+            "dec %1\n\t"
+            "jnz 1b\n\t"
+            : "+r"(d), "+r"(blocks)
+            : "r"(pattern)
+            : "memory");
+    }
+
+    memset_rep(d, c, size & 63);
+    return ptr;
+}
+
+void* memset(void* ptr, int c, size_t size)
+{
+    // ADDED: Pick the cheapest variant for the size
+    if (size < MEMORY_SMALL)
+    {
+        return memset_bytes(ptr, c, size);
+    }
+    if (size < MEMORY_LARGE)
+    {
+        return memset_dwords(ptr, c, size);
+    }
+    return memory_sse2_usable() ? memset_sse2(ptr, c, size) : memset_rep(ptr, c, size);
+}
+
 int memcmp(void* s1, void* s2, int count)
 {
     char* c1 = s1;
@@ -25,7 +183,10 @@ int memcmp(void* s1, void* s2, int count)
     return 0;
 }
 
-void* memcpy(void* dest, const void* src, size_t len)  // FIXED
+// ADDED: ---- memcpy variants (all copy forward, so they are also safe for
+// overlapping regions when dest < src) ----
+
+void* memcpy_bytes(void* dest, const void* src, size_t len)
 {
     char* d = (char*)dest;
     const char* s = (const char*)src;
@@ -36,25 +197,155 @@ void* memcpy(void* dest, const void* src, size_t len)  // FIXED
     return dest;
 }
 
+void* memcpy_dwords(void* dest, const void* src, size_t len)
+{
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+
+    // ADDED: Align the destination; x86 doesn't mind unaligned source reads
+    while (len > 0 && ((uintptr_t)d & 3))
+    {
+        *d++ = *s++;
+        len--;
+    }
+
+    uint32_t* d32 = (uint32_t*)d;
+    const uint32_t* s32 = (const uint32_t*)s;
+    for (size_t i = 0; i < len / 4; i++)
+    {
+        d32[i] = s32[i];
+    }
+
+    d += len & ~(size_t)3;
+    s += len & ~(size_t)3;
+    for (size_t i = 0; i < (len & 3); i++)
+    {
+        d[i] = s[i];
+    }
+    return dest;
+}
+
+void* memcpy_rep(void* dest, const void* src, size_t len)
+{
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+
+    while (len > 0 && ((uintptr_t)d & 3))
+    {
+        *d++ = *s++;
+        len--;
+    }
+
+    // ADDED: rep movsd copies [ESI] to [EDI], ECX dwords
+    size_t count = len / 4;
+    __asm__ volatile ("rep movsl" : "+D"(d), "+S"(s), "+c"(count) :: "memory");
+
+    for (size_t i = 0; i < (len & 3); i++)
+    {
+        d[i] = s[i];
+    }
+    return dest;
+}
+
+void* memcpy_sse2(void* dest, const void* src, size_t len)
+{
+    if (!memory_sse2)
+    {
+        return memcpy_rep(dest, src, len);
+    }
+
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+
+    while (len > 0 && ((uintptr_t)d & 15))
+    {
+        *d++ = *s++;
+        len--;
+    }
+
+    // ADDED: Unaligned 16-byte loads, aligned stores, 64 bytes per iteration.
+    // All four loads come before the stores, which keeps dest < src overlap
+    // safe like the other forward copies.
+    size_t blocks = len / 64;
+    if (blocks > 0)
+    {
+        __asm__ volatile (
+            "1:\n\t"
+            "movdqu (%1), %%xmm0\n\t"
+            "movdqu 16(%1), %%xmm1\n\t"
+            "movdqu 32(%1), %%xmm2\n\t"
+            "movdqu 48(%1), %%xmm3\n\t"
+            "movdqa %%xmm0, (%0)\n\t"
+            "movdqa %%xmm1, 16(%0)\n\t"
+            "movdqa %%xmm2, 32(%0)\n\t"
+            "movdqa %%xmm3, 48(%0)\n\t"
+            "add $64, %0\n\t"
+            "add $64, %1\n\t"
+            "dec %2\n\t"
+            "jnz 1b\n\t"
+            : "+r"(d), "+r"(s), "+r"(blocks)
+            :
+            : "memory");
+    }
+
+    memcpy_rep(d, s, len & 63);
+    return dest;
+}
+
+void* memcpy(void* dest, const void* src, size_t len)  // FIXED
+{
+    // ADDED: Pick the cheapest variant for the size
+    if (len < MEMORY_SMALL)
+    {
+        return memcpy_bytes(dest, src, len);
+    }
+    if (len < MEMORY_LARGE)
+    {
+        return memcpy_dwords(dest, src, len);
+    }
+    return memory_sse2_usable() ? memcpy_sse2(dest, src, len) : memcpy_rep(dest, src, len);
+}
+
 // ADDED: Move memory (handles overlapping regions)
 void* memmove(void* dest, const void* src, size_t n)
 {
     unsigned char* d = (unsigned char*)dest;
     const unsigned char* s = (const unsigned char*)src;
-    
-    if (d < s)
+
+    if (d <= s || d >= s + n)
     {
-        // ADDED: Copy forward (source is before destination)
-        for (size_t i = 0; i < n; i++)
-            d[i] = s[i];
+        // ADDED: No overlap, or source ahead of destination - the forward
+        // copies handle both
+        return memcpy(dest, src, n);
     }
-    else if (d > s)
+
+    // ADDED: Destination overlaps the end of the source - copy backward.
+    // Tail bytes until the destination end is dword aligned...
+    d += n;
+    s += n;
+    while (n > 0 && ((uintptr_t)d & 3))
     {
-        // ADDED: Copy backward (destination is before source)
-        for (size_t i = n; i > 0; i--)
-            d[i - 1] = s[i - 1];
+        *--d = *--s;
+        n--;
     }
-    // ADDED: If d == s, do nothing (same address)
-    
+
+    // ADDED: ...then whole dwords with the direction flag set...
+    size_t count = n / 4;
+    if (count > 0)
+    {
+        d -= 4;
+        s -= 4;
+        __asm__ volatile ("std\n\trep movsl\n\tcld"
+                          : "+D"(d), "+S"(s), "+c"(count) :: "memory");
+        d += 4;
+        s += 4;
+    }
+
+    // ADDED: ...then the leading bytes
+    for (size_t i = 0; i < (n & 3); i++)
+    {
+        *--d = *--s;
+    }
+
     return dest;
-}
\ No newline at end of file
+}
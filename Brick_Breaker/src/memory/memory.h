@@ -8,4 +8,19 @@ int memcmp(void* s1, void* s2, int count);
 void* memcpy(void* dest, const void* src, size_t len);  // FIXED: size_t
 void* memmove(void* dest, const void* src, size_t n);  // ADDED: Move memory (handles overlap)
 
+// ADDED: Detect SSE2 and enable it for memset/memcpy (call once, early)
+void memory_init();
+int memory_has_sse2();
+
+// ADDED: The individual strategies memset/memcpy choose between by size
+// (exposed for the benchmark). The SSE2 ones fall back to rep without SSE2.
+void* memset_bytes(void* ptr, int c, size_t size);
+void* memset_dwords(void* ptr, int c, size_t size);
+void* memset_rep(void* ptr, int c, size_t size);
+void* memset_sse2(void* ptr, int c, size_t size);
+void* memcpy_bytes(void* dest, const void* src, size_t len);
+void* memcpy_dwords(void* dest, const void* src, size_t len);
+void* memcpy_rep(void* dest, const void* src, size_t len);
+void* memcpy_sse2(void* dest, const void* src, size_t len);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include "mixer.h"
+
+// ADDED: Clip/stop requests waiting for the interrupt (power of two)
+#define MIXER_QUEUE_SIZE 8
+
+// ADDED: Square wave amplitude of a tone channel (of 32767)
+#define MIXER_TONE_LEVEL (48 << 8)
+
+typedef struct {
+    const uint8_t* samples;   // 0 = stop everything
+    uint32_t length;
+    uint32_t step;            // 16.16 samples per output sample
+    uint8_t volume;
+} mixer_request_t;
+
+typedef struct {
+    const uint8_t* samples;   // 0 = voice free
+    uint32_t end;             // length in 16.16
+    uint32_t position;        // 16.16
+    uint32_t step;
+    int volume;
+} mixer_voice_t;
+
+typedef struct {
+    uint32_t phase;           // 16.16 fraction of a wave period
+    uint32_t step;            // 0 = off
+} mixer_tone_t;
+
+static volatile uint32_t mixer_rate = 0;   // 0 = no backend running
+
+// ADDED: Requests and the stream are single-producer (game loop),
+// single-consumer (interrupt) rings: each side only moves its own index
+static mixer_request_t requests[MIXER_QUEUE_SIZE];
+static volatile uint32_t request_head = 0;
+static volatile uint32_t request_tail = 0;
+
+static uint8_t stream[MIXER_STREAM_SIZE];
+static volatile uint32_t stream_head = 0;
+static volatile uint32_t stream_tail = 0;
+
+// ADDED: Owned by the interrupt
+static mixer_voice_t voices[MIXER_VOICES];
+static mixer_tone_t tones[MIXER_TONES];
+
+/* ============================================================================
+ * QUEUEING
+ * ============================================================================
+ */
+
+void mixer_start(uint32_t rate)
+{
+    for (int v = 0; v < MIXER_VOICES; v++)
+    {
+        voices[v].samples = 0;
+    }
+    for (int t = 0; t < MIXER_TONES; t++)
+    {
+        tones[t].step = 0;
+    }
+    request_head = request_tail;
+    stream_head = stream_tail;
+
+    mixer_rate = rate;
+}
+
+void mixer_shutdown()
+{
+    mixer_rate = 0;
+}
+
+bool mixer_active()
+{
+    return mixer_rate != 0;
+}
+
+static bool mixer_queue(const uint8_t* samples, uint32_t length, uint32_t step, uint8_t volume)
+{
+    uint32_t tail = request_tail;
+    if (tail - request_head == MIXER_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    mixer_request_t* request = &requests[tail & (MIXER_QUEUE_SIZE - 1)];
+    request->samples = samples;
+    request->length = length;
+    request->step = step;
+    request->volume = volume;
+
+    // ADDED: The request must be written before the interrupt can see it
+    __asm__ volatile ("" ::: "memory");
+    request_tail = tail + 1;
+    return true;
+}
+
+bool mixer_play(const uint8_t* samples, uint32_t length, uint32_t rate, uint8_t volume)
+{
+    uint32_t output_rate = mixer_rate;
+
+    if (output_rate == 0 || !samples || length == 0 || length > 0xFFFF)
+    {
+        return false;
+    }
+
+    return mixer_queue(samples, length, (rate << 16) / output_rate, volume);
+}
+
+uint32_t mixer_stream_write(const uint8_t* samples, uint32_t count)
+{
+    if (mixer_rate == 0)
+    {
+        return 0;
+    }
+
+    uint32_t tail = stream_tail;
+    uint32_t space = MIXER_STREAM_SIZE - (tail - stream_head);
+    if (count > space)
+    {
+        count = space;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        stream[(tail + i) & (MIXER_STREAM_SIZE - 1)] = samples[i];
+    }
+
+    __asm__ volatile ("" ::: "memory");
+    stream_tail = tail + count;
+    return count;
+}
+
+void mixer_stop()
+{
+    mixer_queue(0, 0, 0, 0);
+}
+
+void mixer_set_tone(int tone, uint16_t frequency)
+{
+    uint32_t rate = mixer_rate;
+
+    if (tone >= 0 && tone < MIXER_TONES && rate != 0)
+    {
+        // ADDED: 65536 steps per period, so step = frequency / rate in 16.16
+        tones[tone].step = ((uint32_t)frequency << 16) / rate;
+    }
+}
+
+/* ============================================================================
+ * MIXING (INTERRUPT)
+ * ============================================================================
+ */
+
+// ADDED: Take the queued clips into free voices (or stop everything)
+static void mixer_take_requests()
+{
+    while (request_head != request_tail)
+    {
+        const mixer_request_t* request = &requests[request_head & (MIXER_QUEUE_SIZE - 1)];
+
+        if (!request->samples)
+        {
+            for (int v = 0; v < MIXER_VOICES; v++)
+            {
+                voices[v].samples = 0;
+            }
+            stream_head = stream_tail;
+        }
+        else
+        {
+            // ADDED: All voices busy - the one nearest its end makes way
+            mixer_voice_t* voice = &voices[0];
+            for (int v = 0; v < MIXER_VOICES; v++)
+            {
+                if (!voices[v].samples)
+                {
+                    voice = &voices[v];
+                    break;
+                }
+                if (voices[v].end - voices[v].position < voice->end - voice->position)
+                {
+                    voice = &voices[v];
+                }
+            }
+
+            voice->end = request->length << 16;
+            voice->position = 0;
+            voice->step = request->step;
+            voice->volume = request->volume;
+            voice->samples = request->samples;
+        }
+        request_head++;
+    }
+}
+
+// ADDED: Sum every source for one output sample (false = all silent)
+static inline bool mixer_mix_one(int* sample)
+{
+    int mix = 0;
+    bool playing = false;
+
+    for (int v = 0; v < MIXER_VOICES; v++)
+    {
+        mixer_voice_t* voice = &voices[v];
+        if (!voice->samples)
+        {
+            continue;
+        }
+
+        mix += (voice->samples[voice->position >> 16] - 128) * voice->volume;
+        playing = true;
+
+        voice->position += voice->step;
+        if (voice->position >= voice->end)
+        {
+            voice->samples = 0;
+        }
+    }
+
+    uint32_t head = stream_head;
+    if (head != stream_tail)
+    {
+        mix += (stream[head & (MIXER_STREAM_SIZE - 1)] - 128) << 8;
+        stream_head = head + 1;
+        playing = true;
+    }
+
+    for (int t = 0; t < MIXER_TONES; t++)
+    {
+        if (tones[t].step)
+        {
+            mix += (tones[t].phase & 0x8000) ? MIXER_TONE_LEVEL : -MIXER_TONE_LEVEL;
+            tones[t].phase += tones[t].step;
+            playing = true;
+        }
+    }
+
+    if (mix < -32768) mix = -32768;
+    if (mix > 32767) mix = 32767;
+
+    *sample = mix;
+    return playing;
+}
+
+bool mixer_sample(int* sample)
+{
+    if (request_head != request_tail)
+    {
+        mixer_take_requests();
+    }
+
+    return mixer_mix_one(sample);
+}
+
+void mixer_render16(int16_t* out, uint32_t count)
+{
+    int sample;
+
+    mixer_take_requests();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mixer_mix_one(&sample);
+        out[i] = (int16_t)sample;
+    }
+}
+
+void mixer_render8(uint8_t* out, uint32_t count)
+{
+    int sample;
+
+    mixer_take_requests();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mixer_mix_one(&sample);
+        out[i] = (uint8_t)((sample >> 8) + 128);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Software mixer shared by the sample-based sound backends (PCM on
+// the speaker, Sound Blaster 16). A backend calls mixer_start() with its
+// output rate and then pulls mixed samples from its interrupt; everyone
+// else only queues sounds.
+//
+// Sources mixed together, in 16-bit fixed point:
+// - MIXER_VOICES one-shot clips of 8-bit unsigned samples (mixer_play)
+// - A ring buffer of 8-bit samples the caller keeps filled
+//   (mixer_stream_write)
+// - MIXER_TONES square waves, one per speaker priority (music and
+//   effects), set by the speaker scheduler
+
+#define MIXER_VOICES 4
+#define MIXER_TONES 2
+
+// ADDED: Samples the stream ring holds (power of two)
+#define MIXER_STREAM_SIZE 4096
+
+// ADDED: A backend starts / stops pulling samples at rate Hz
+void mixer_start(uint32_t rate);
+void mixer_shutdown();
+bool mixer_active();
+
+// ADDED: Queue a clip (played at rate Hz, volume 0-255). The samples must
+// stay in place until it has played. Returns false if the queue is full
+// or no backend is running.
+bool mixer_play(const uint8_t* samples, uint32_t length, uint32_t rate, uint8_t volume);
+
+// ADDED: Append to the stream; returns how many samples fit
+uint32_t mixer_stream_write(const uint8_t* samples, uint32_t count);
+
+// ADDED: Stop the clips and empty the stream
+void mixer_stop();
+
+// ADDED: Square wave on one tone channel (0 Hz = off). Interrupt context.
+void mixer_set_tone(int tone, uint16_t frequency);
+
+// ADDED: For backends, from their interrupt. mixer_sample gives one
+// signed 16-bit sample and returns false if everything is silent; the
+// render functions fill a whole block in the card's format.
+bool mixer_sample(int* sample);
+void mixer_render16(int16_t* out, uint32_t count);   // Signed
+void mixer_render8(uint8_t* out, uint32_t count);    // Unsigned
+
+#endif
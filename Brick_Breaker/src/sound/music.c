@@ -0,0 +1,642 @@
+#include "music.h"
+#include "speaker.h"
+#include "opl2.h"
+#include "fs/file.h"
+#include "status.h"
+
+// ADDED: One row is this much of row_time: rows_per_minute is added to it
+// every millisecond, and 60000 ms make a minute
+#define MUSIC_ROW_UNITS 60000
+
+// ADDED: Each note lets go this long before the next row, so repeated
+// notes are heard as separate notes
+#define MUSIC_RELEASE_MS 8
+
+// ADDED: Order list entries kept while parsing
+#define MUSIC_MAX_ORDER 64
+
+// ADDED: Longest line of a song file
+#define MUSIC_MAX_LINE 128
+
+// ADDED: Octave 8, C to B, in Hz. Lower octaves halve it; octave 0 would
+// need a PIT divisor over 16 bits, so songs go from octave 1 to 8.
+static const uint16_t octave_8[12] = {
+    4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902
+};
+
+// ADDED: Semitone of each note letter, A to G
+static const uint8_t letter_semitones[7] = { 9, 11, 0, 2, 4, 5, 7 };
+
+// ADDED: Parser scratch: the patterns' notes before each track's order
+// list lays them out in the song. Songs are loaded from the game loop only.
+typedef struct {
+    uint16_t first;
+    uint16_t count;
+    bool defined;
+} music_pattern_t;
+
+typedef struct {
+    uint8_t order[MUSIC_MAX_ORDER];
+    int order_count;
+    bool order_given;
+    uint32_t loop;
+    uint32_t instrument;
+} music_track_order_t;
+
+typedef struct {
+    int pattern;              // Pattern notes go into (-1 = none yet)
+    int track;                // Track order/loop/instrument apply to
+    uint32_t tempo;
+    uint32_t rows_per_beat;
+    music_track_order_t tracks[MUSIC_TRACKS];
+} music_parser_t;
+
+static music_event_t pattern_events[MUSIC_MAX_PATTERN_EVENTS];
+static uint16_t pattern_event_count;
+static music_pattern_t patterns[MUSIC_MAX_PATTERNS];
+static music_parser_t parser;
+
+static char file_buffer[MUSIC_MAX_FILE];
+
+// ADDED: Set by the game, read by the interrupt
+static const music_song_t* volatile requested_song = 0;
+static volatile bool music_paused = false;
+
+// ADDED: Owned by the interrupt
+typedef struct {
+    uint16_t position;        // Event being played
+    uint32_t rows_left;       // Rows of it still to go, this one included
+    bool sounding;            // The output has been given this event
+} music_voice_t;
+
+static const music_song_t* playing = 0;
+static music_voice_t voices[MUSIC_TRACKS];
+static uint32_t row_time = 0;       // Into the current row, of MUSIC_ROW_UNITS
+static bool held = false;           // Paused and silenced
+
+/* ============================================================================
+ * PARSING
+ * ============================================================================
+ */
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// ADDED: Next space-separated word of the line (length 0 at the end)
+static const char* next_token(const char** cursor, int* length)
+{
+    const char* start = *cursor;
+    while (is_space(*start))
+    {
+        start++;
+    }
+
+    const char* end = start;
+    while (*end && !is_space(*end))
+    {
+        end++;
+    }
+
+    *cursor = end;
+    *length = end - start;
+    return start;
+}
+
+static bool token_is(const char* token, int length, const char* word)
+{
+    int i = 0;
+    for (; i < length; i++)
+    {
+        if (word[i] != token[i])
+        {
+            return false;
+        }
+    }
+    return word[i] == 0;
+}
+
+static bool parse_number(const char* token, int length, uint32_t* value)
+{
+    if (length == 0 || length > 5)
+    {
+        return false;
+    }
+
+    *value = 0;
+    for (int i = 0; i < length; i++)
+    {
+        if (token[i] < '0' || token[i] > '9')
+        {
+            return false;
+        }
+        *value = *value * 10 + (token[i] - '0');
+    }
+    return true;
+}
+
+// ADDED: "C#5:2" / "Eb4" / "-:4" into an event
+static bool parse_note(const char* token, int length, music_event_t* event)
+{
+    int note_length = 0;
+    while (note_length < length && token[note_length] != ':')
+    {
+        note_length++;
+    }
+
+    uint32_t rows = 1;
+    if (note_length < length &&
+        !parse_number(token + note_length + 1, length - note_length - 1, &rows))
+    {
+        return false;
+    }
+    if (rows == 0 || rows > 0xFFFF)
+    {
+        return false;
+    }
+    event->rows = (uint16_t)rows;
+
+    if (note_length == 1 && token[0] == '-')
+    {
+        event->frequency = 0;
+        return true;
+    }
+
+    char letter = token[0] & ~0x20;   // Upper case
+    if (note_length < 2 || letter < 'A' || letter > 'G')
+    {
+        return false;
+    }
+
+    int semitone = letter_semitones[letter - 'A'];
+    int i = 1;
+    if (token[i] == '#')
+    {
+        semitone++;
+        i++;
+    }
+    else if (token[i] == 'b')
+    {
+        semitone--;
+        i++;
+    }
+
+    if (i != note_length - 1 || token[i] < '1' || token[i] > '8')
+    {
+        return false;
+    }
+    int octave = token[i] - '0';
+
+    // ADDED: B#/Cb cross into the next/previous octave
+    if (semitone < 0)
+    {
+        semitone += 12;
+        octave--;
+    }
+    else if (semitone > 11)
+    {
+        semitone -= 12;
+        octave++;
+    }
+    if (octave < 1 || octave > 8)
+    {
+        return false;
+    }
+
+    event->frequency = octave_8[semitone] >> (8 - octave);
+    return true;
+}
+
+// ADDED: One line, comment already cut off
+static int parse_line(const char* line)
+{
+    const char* cursor = line;
+    int length;
+    const char* command = next_token(&cursor, &length);
+    music_track_order_t* track = &parser.tracks[parser.track];
+    uint32_t value;
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    if (token_is(command, length, "order"))
+    {
+        track->order_given = true;
+        track->order_count = 0;
+        while (true)
+        {
+            const char* argument = next_token(&cursor, &length);
+            if (length == 0)
+            {
+                break;
+            }
+            if (!parse_number(argument, length, &value) || value >= MUSIC_MAX_PATTERNS ||
+                track->order_count == MUSIC_MAX_ORDER)
+            {
+                return -EINVARG;
+            }
+            track->order[track->order_count++] = (uint8_t)value;
+        }
+        return 0;
+    }
+
+    bool tempo = token_is(command, length, "tempo");
+    bool rows = token_is(command, length, "rows");
+    bool pattern = token_is(command, length, "pattern");
+    bool loop = token_is(command, length, "loop");
+    bool track_command = token_is(command, length, "track");
+    bool instrument = token_is(command, length, "instrument");
+
+    if (tempo || rows || pattern || loop || track_command || instrument)
+    {
+        const char* argument = next_token(&cursor, &length);
+        if (!parse_number(argument, length, &value))
+        {
+            return -EINVARG;
+        }
+
+        if (tempo)
+        {
+            parser.tempo = value;
+        }
+        else if (rows)
+        {
+            parser.rows_per_beat = value;
+        }
+        else if (loop)
+        {
+            track->loop = value;
+        }
+        else if (instrument)
+        {
+            track->instrument = value;
+        }
+        else if (track_command)
+        {
+            if (value >= MUSIC_TRACKS)
+            {
+                return -EINVARG;
+            }
+            parser.track = value;
+        }
+        else
+        {
+            // ADDED: Each pattern is defined once, its notes in one run
+            if (value >= MUSIC_MAX_PATTERNS || patterns[value].defined)
+            {
+                return -EINVARG;
+            }
+            parser.pattern = value;
+            patterns[value].defined = true;
+            patterns[value].first = pattern_event_count;
+            patterns[value].count = 0;
+
+            // ADDED: Without an order list, a track plays its patterns as
+            // defined
+            if (!track->order_given && track->order_count < MUSIC_MAX_ORDER)
+            {
+                track->order[track->order_count++] = (uint8_t)value;
+            }
+        }
+        return 0;
+    }
+
+    // ADDED: Anything else is a line of notes
+    if (parser.pattern < 0)
+    {
+        return -EINVARG;
+    }
+    cursor = line;
+    while (true)
+    {
+        const char* token = next_token(&cursor, &length);
+        if (length == 0)
+        {
+            break;
+        }
+        if (pattern_event_count == MUSIC_MAX_PATTERN_EVENTS ||
+            !parse_note(token, length, &pattern_events[pattern_event_count]))
+        {
+            return -EINVARG;
+        }
+        pattern_event_count++;
+        patterns[parser.pattern].count++;
+    }
+    return 0;
+}
+
+// ADDED: Lay a track's patterns out in order: the interrupt only ever
+// walks a flat list
+static int build_track(music_track_t* track, const music_track_order_t* order)
+{
+    uint16_t count = 0;
+
+    track->count = 0;
+    if (order->order_count == 0)
+    {
+        return 0;   // Track not used
+    }
+
+    if (order->loop >= (uint32_t)order->order_count || order->instrument >= OPL2_INSTRUMENTS)
+    {
+        return -EINVARG;
+    }
+
+    for (int o = 0; o < order->order_count; o++)
+    {
+        const music_pattern_t* entry = &patterns[order->order[o]];
+        if (!entry->defined || count + entry->count > MUSIC_MAX_EVENTS)
+        {
+            return -EINVARG;
+        }
+
+        if (o == (int)order->loop)
+        {
+            track->loop = count;
+        }
+        for (int e = 0; e < entry->count; e++)
+        {
+            track->events[count++] = pattern_events[entry->first + e];
+        }
+    }
+
+    if (count == 0 || track->loop >= count)
+    {
+        return -EINVARG;
+    }
+
+    track->instrument = (uint8_t)order->instrument;
+    track->count = count;
+    return 0;
+}
+
+int music_parse(music_song_t* song, const char* text, uint32_t length)
+{
+    int res = 0;
+    char line[MUSIC_MAX_LINE];
+
+    song->count = 0;
+    pattern_event_count = 0;
+    for (int p = 0; p < MUSIC_MAX_PATTERNS; p++)
+    {
+        patterns[p].defined = false;
+    }
+
+    parser.pattern = -1;
+    parser.track = 0;
+    parser.tempo = 120;
+    parser.rows_per_beat = 4;
+    for (int t = 0; t < MUSIC_TRACKS; t++)
+    {
+        parser.tracks[t].order_count = 0;
+        parser.tracks[t].order_given = false;
+        parser.tracks[t].loop = 0;
+        parser.tracks[t].instrument = 0;
+    }
+
+    uint32_t i = 0;
+    while (i < length)
+    {
+        // ADDED: Copy out one line, dropping the comment
+        int line_length = 0;
+        bool comment = false;
+        while (i < length && text[i] != '\n')
+        {
+            if (text[i] == ';' || text[i] == 0)
+            {
+                comment = true;
+            }
+            if (!comment)
+            {
+                if (line_length == MUSIC_MAX_LINE - 1)
+                {
+                    res = -EINVARG;
+                    goto out;
+                }
+                line[line_length++] = text[i];
+            }
+            i++;
+        }
+        line[line_length] = 0;
+        i++;
+
+        res = parse_line(line);
+        if (res < 0)
+        {
+            goto out;
+        }
+    }
+
+    // ADDED: At most one row per millisecond
+    uint32_t rows_per_minute = parser.tempo * parser.rows_per_beat;
+    if (parser.tempo == 0 || parser.rows_per_beat == 0 || parser.tempo > MUSIC_ROW_UNITS ||
+        rows_per_minute > MUSIC_ROW_UNITS)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    uint16_t count = 0;
+    for (int t = 0; t < MUSIC_TRACKS; t++)
+    {
+        res = build_track(&song->tracks[t], &parser.tracks[t]);
+        if (res < 0)
+        {
+            goto out;
+        }
+        count += song->tracks[t].count;
+    }
+
+    if (count == 0)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    song->rows_per_minute = rows_per_minute;
+    song->count = count;
+
+out:
+    return res;
+}
+
+int music_load(music_song_t* song, const char* path)
+{
+    int res = 0;
+    struct file_stat stat;
+
+    song->count = 0;
+    int fd = fopen(path, "r");
+    if (!fd)
+    {
+        return -EIO;
+    }
+
+    res = fstat(fd, &stat);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    if (stat.filesize == 0 || stat.filesize > MUSIC_MAX_FILE)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    if (fread(file_buffer, stat.filesize, 1, fd) != 1)
+    {
+        res = -EIO;
+        goto out;
+    }
+
+    res = music_parse(song, file_buffer, stat.filesize);
+
+out:
+    fclose(fd);
+    return res;
+}
+
+/* ============================================================================
+ * SEQUENCING (INTERRUPT)
+ * ============================================================================
+ */
+
+void music_play(const music_song_t* song)
+{
+    if (song && song->count == 0)
+    {
+        song = 0;
+    }
+    requested_song = song;
+}
+
+void music_pause(bool paused)
+{
+    music_paused = paused;
+}
+
+// ADDED: A track's note to whatever plays the music: an OPL2 channel
+// each, or the speaker's music voice for the first track alone
+static void music_output(int track, uint16_t frequency, uint16_t duration_ms)
+{
+    if (opl2_active())
+    {
+        opl2_note(track, frequency, duration_ms);
+    }
+    else if (track == 0)
+    {
+        speaker_set(frequency, duration_ms, SPEAKER_MUSIC);
+    }
+}
+
+static void music_silence()
+{
+    for (int t = 0; t < MUSIC_TRACKS; t++)
+    {
+        music_output(t, 0, 0);
+        voices[t].sounding = false;
+    }
+}
+
+// ADDED: Hand a track's current event out for as long as it has left
+static void music_sound(int track)
+{
+    music_voice_t* voice = &voices[track];
+    const music_event_t* event = &playing->tracks[track].events[voice->position];
+    uint32_t rows_per_minute = playing->rows_per_minute;
+    uint32_t ms = (voice->rows_left * MUSIC_ROW_UNITS - row_time + rows_per_minute - 1) /
+                  rows_per_minute;
+
+    if (ms > 2 * MUSIC_RELEASE_MS)
+    {
+        ms -= MUSIC_RELEASE_MS;
+    }
+
+    music_output(track, event->frequency, ms > 0xFFFF ? 0xFFFF : (uint16_t)ms);
+    voice->sounding = true;
+}
+
+// ADDED: Start a song (or none) from the top
+static void music_start(const music_song_t* song)
+{
+    music_silence();
+
+    playing = song;
+    row_time = 0;
+    for (int t = 0; t < MUSIC_TRACKS; t++)
+    {
+        voices[t].position = 0;
+        voices[t].rows_left = 0;
+        if (song && song->tracks[t].count)
+        {
+            voices[t].rows_left = song->tracks[t].events[0].rows;
+            if (opl2_active())
+            {
+                opl2_set_instrument(t, song->tracks[t].instrument);
+            }
+        }
+    }
+}
+
+void music_tick()
+{
+    const music_song_t* song = requested_song;
+
+    if (song != playing)
+    {
+        music_start(song);
+    }
+
+    if (!playing)
+    {
+        return;
+    }
+
+    if (music_paused)
+    {
+        if (!held)
+        {
+            music_silence();
+            held = true;
+        }
+        return;
+    }
+    held = false;
+
+    // ADDED: A millisecond of the song; a whole row is MUSIC_ROW_UNITS.
+    // All tracks share the tempo, each walks its own list.
+    row_time += playing->rows_per_minute;
+    while (row_time >= MUSIC_ROW_UNITS)
+    {
+        row_time -= MUSIC_ROW_UNITS;
+        for (int t = 0; t < MUSIC_TRACKS; t++)
+        {
+            const music_track_t* track = &playing->tracks[t];
+            music_voice_t* voice = &voices[t];
+            if (track->count == 0 || --voice->rows_left != 0)
+            {
+                continue;
+            }
+
+            voice->position++;
+            if (voice->position >= track->count)
+            {
+                voice->position = track->loop;
+            }
+            voice->rows_left = track->events[voice->position].rows;
+            voice->sounding = false;
+        }
+    }
+
+    for (int t = 0; t < MUSIC_TRACKS; t++)
+    {
+        if (playing->tracks[t].count && !voices[t].sounding)
+        {
+            music_sound(t);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef MUSIC_H
+#define MUSIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Music sequencer. Songs are text files in a small tracker-style
+// format, parsed once when loaded into a flat list of notes per track;
+// the timer interrupt then steps through those lists every millisecond, so
+// the tempo is exact and the game loop does no work for the music at all.
+//
+// With an AdLib (sound/opl2.h) every track plays on its own FM channel;
+// on the PC speaker only track 0, the melody, is heard.
+//
+// Song format (one command per line, ';' starts a comment):
+//
+//   tempo 120          ; beats per minute
+//   rows 4             ; rows per beat (the shortest note)
+//   pattern 0          ; following notes go into pattern 0 (0-15)
+//   C5:2 E5:2 G5:4     ; note and octave (C#5, Db5 ...), ':' length in rows
+//   -:4                ; rest (the length defaults to 1 row)
+//   order 0 0 1        ; patterns in playing order (default: as defined)
+//   loop 1             ; order entry to loop back to (default 0)
+//   track 1            ; order, loop, instrument and new patterns from
+//                      ; here on are for track 1 (0-3, default 0)
+//   instrument 2       ; AdLib instrument of the track (see opl2.h)
+
+#define MUSIC_TRACKS 4
+#define MUSIC_MAX_EVENTS 256           // Per track
+#define MUSIC_MAX_PATTERNS 16
+#define MUSIC_MAX_PATTERN_EVENTS 512   // All patterns together
+
+// ADDED: Largest song file music_load reads
+#define MUSIC_MAX_FILE 8192
+
+typedef struct {
+    uint16_t frequency;   // 0 = rest
+    uint16_t rows;
+} music_event_t;
+
+typedef struct {
+    music_event_t events[MUSIC_MAX_EVENTS];
+    uint16_t count;              // 0 = track not used
+    uint16_t loop;               // Event the track loops back to
+    uint8_t instrument;
+} music_track_t;
+
+typedef struct {
+    music_track_t tracks[MUSIC_TRACKS];
+    uint16_t count;              // Events in all tracks (0 = empty song)
+    uint32_t rows_per_minute;    // tempo * rows per beat
+} music_song_t;
+
+// ADDED: Parse a song from memory / from a file such as "0:/LEVEL1.SNG".
+// Return 0 or a negative status (-EINVARG for a bad song, -EIO if the
+// file can't be read); song is left empty on failure.
+int music_parse(music_song_t* song, const char* text, uint32_t length);
+int music_load(music_song_t* song, const char* path);
+
+// ADDED: Start a song from the top (0 = stop); playing the song that is
+// already on changes nothing. The song must stay in place while it plays.
+void music_play(const music_song_t* song);
+
+// ADDED: Hold the music where it is (silent) or carry on
+void music_pause(bool paused);
+
+// ADDED: Called by the timer interrupt every millisecond
+void music_tick();
+
+#endif
@@ -0,0 +1,364 @@
+#include "opl2.h"
+#include "io/io.h"
+#include "idt/idt.h"
+
+#define OPL2_ADDRESS    0x388   // Register index out, status in
+#define OPL2_DATA       0x389
+
+// ADDED: Status reads to wait after writing the index (3.3 us) and the data
+// (23 us); a port read takes about 1 us on the ISA bus
+#define OPL2_INDEX_DELAY 6
+#define OPL2_DATA_DELAY  35
+
+// ADDED: Register groups (channel or operator offset added)
+#define OPL2_TEST           0x01
+#define OPL2_TIMER_1        0x02
+#define OPL2_TIMER_CONTROL  0x04
+#define OPL2_CHARACTER      0x20    // Tremolo, vibrato, sustain, KSR, multiplier
+#define OPL2_LEVEL          0x40    // Key scaling, attenuation
+#define OPL2_ATTACK_DECAY   0x60
+#define OPL2_SUSTAIN_RELEASE 0x80
+#define OPL2_FNUMBER_LOW    0xA0
+#define OPL2_KEY_BLOCK      0xB0    // Key on, block, F-number bits 8-9
+#define OPL2_FEEDBACK       0xC0    // Feedback, connection
+#define OPL2_WAVEFORM       0xE0
+
+#define OPL2_KEY_ON         0x20
+#define OPL2_WAVE_SELECT    0x20    // In OPL2_TEST: allow waveforms 1-3
+
+// ADDED: The chip's clock / 72, in Hz
+#define OPL2_SAMPLE_RATE    49716
+
+// ADDED: One instrument: modulator and carrier operator settings
+typedef struct {
+    uint8_t character[2];
+    uint8_t level[2];
+    uint8_t attack_decay[2];
+    uint8_t sustain_release[2];
+    uint8_t waveform[2];
+    uint8_t feedback;
+} opl2_patch_t;
+
+static const opl2_patch_t patches[OPL2_INSTRUMENTS] = {
+    //                             character     level         AD            SR            wave      fb
+    [OPL2_INSTRUMENT_PIANO]  = { { 0x01, 0x11 }, { 0x4F, 0x00 }, { 0xF1, 0xD2 }, { 0x53, 0x74 }, { 0, 0 }, 0x06 },
+    [OPL2_INSTRUMENT_BASS]   = { { 0x21, 0x21 }, { 0x1B, 0x02 }, { 0xF5, 0xF5 }, { 0x57, 0x28 }, { 1, 0 }, 0x0A },
+    [OPL2_INSTRUMENT_ORGAN]  = { { 0x22, 0x21 }, { 0x1F, 0x06 }, { 0xF0, 0xF0 }, { 0x0F, 0x0F }, { 1, 0 }, 0x01 },
+    [OPL2_INSTRUMENT_SQUARE] = { { 0x22, 0x21 }, { 0x16, 0x04 }, { 0xF4, 0xF2 }, { 0x15, 0x18 }, { 2, 0 }, 0x0C },
+    [OPL2_INSTRUMENT_BELL]   = { { 0x07, 0x12 }, { 0x25, 0x00 }, { 0xF5, 0xF4 }, { 0x24, 0x35 }, { 0, 0 }, 0x08 },
+};
+
+// ADDED: Modulator operator of each channel (the carrier is 3 further on)
+static const uint8_t channel_operators[OPL2_CHANNELS] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+
+static bool active = false;
+
+// ADDED: What the chip holds, and what it should hold once every change
+// is sent. Changed registers wait in a ring in the order first changed, so
+// a note's F-number still goes out before its key on. A register is in
+// the ring at most once, so 256 entries always fit.
+static uint8_t chip[256];
+static uint8_t wanted[256];
+static uint8_t changed[256];
+static uint8_t changed_head = 0;
+static int changed_count = 0;
+static uint32_t changed_bits[256 / 32];
+
+// ADDED: Note waiting for its channel's key off to reach the chip, so
+// every note starts with a fresh key on, even at the same pitch
+typedef struct {
+    uint16_t fnumber;
+    uint8_t block;
+    uint16_t duration_ms;
+    bool waiting;
+} opl2_pending_t;
+
+static opl2_pending_t pending[OPL2_CHANNELS];
+
+// ADDED: Milliseconds until each channel's note is keyed off (0 = none)
+static uint16_t remaining_ms[OPL2_CHANNELS];
+
+/* ============================================================================
+ * REGISTERS
+ * ============================================================================
+ */
+
+static void opl2_delay(int reads)
+{
+    for (int i = 0; i < reads; i++)
+    {
+        insb(OPL2_ADDRESS);
+    }
+}
+
+// ADDED: Straight to the chip, with the delays it needs
+static void opl2_write(uint8_t reg, uint8_t value)
+{
+    outb(OPL2_ADDRESS, reg);
+    opl2_delay(OPL2_INDEX_DELAY);
+    outb(OPL2_DATA, value);
+    opl2_delay(OPL2_DATA_DELAY);
+}
+
+// ADDED: Into the shadow; sent by opl2_flush if it changes anything
+static void opl2_set(uint8_t reg, uint8_t value)
+{
+    wanted[reg] = value;
+
+    uint32_t bit = 1u << (reg & 31);
+    if (!(changed_bits[reg >> 5] & bit))
+    {
+        changed_bits[reg >> 5] |= bit;
+        changed[(uint8_t)(changed_head + changed_count)] = reg;
+        changed_count++;
+    }
+}
+
+static bool opl2_queued(uint8_t reg)
+{
+    return changed_bits[reg >> 5] & (1u << (reg & 31));
+}
+
+// ADDED: Send every changed register, oldest change first. Registers
+// changed back to what the chip has cost nothing. Main loop only: the timer
+// interrupt changes the shadow too, so each register is taken and written
+// with interrupts off. One write (about 40 us) is shorter than a PCM sample
+// period, so the timer interrupt is late at worst, never lost.
+static void opl2_flush()
+{
+    while (1)
+    {
+        disable_interrupts();
+        if (changed_count == 0)
+        {
+            enable_interrupts();
+            return;
+        }
+
+        uint8_t reg = changed[changed_head++];
+        changed_count--;
+        changed_bits[reg >> 5] &= ~(1u << (reg & 31));
+
+        if (wanted[reg] != chip[reg])
+        {
+            opl2_write(reg, wanted[reg]);
+            chip[reg] = wanted[reg];
+        }
+        enable_interrupts();
+    }
+}
+
+/* ============================================================================
+ * DETECTION
+ * ============================================================================
+ */
+
+// ADDED: Start timer 1 and see whether it expires (the usual AdLib check)
+static bool opl2_detect()
+{
+    opl2_write(OPL2_TIMER_CONTROL, 0x60);   // Reset both timers
+    opl2_write(OPL2_TIMER_CONTROL, 0x80);   // Reset the IRQ flag
+    uint8_t before = insb(OPL2_ADDRESS) & 0xE0;
+
+    opl2_write(OPL2_TIMER_1, 0xFF);
+    opl2_write(OPL2_TIMER_CONTROL, 0x21);   // Start timer 1
+    opl2_delay(100);                        // It expires after 80 us
+    uint8_t after = insb(OPL2_ADDRESS) & 0xE0;
+
+    opl2_write(OPL2_TIMER_CONTROL, 0x60);
+    opl2_write(OPL2_TIMER_CONTROL, 0x80);
+
+    return before == 0x00 && after == 0xC0;
+}
+
+bool opl2_init()
+{
+    if (active)
+    {
+        return true;
+    }
+
+    if (!opl2_detect())
+    {
+        return false;
+    }
+
+    // ADDED: Every register to 0 (all notes off), shadow to match
+    for (int reg = 0x01; reg <= 0xF5; reg++)
+    {
+        opl2_write((uint8_t)reg, 0);
+    }
+    for (int reg = 0; reg < 256; reg++)
+    {
+        chip[reg] = 0;
+        wanted[reg] = 0;
+    }
+    for (int i = 0; i < 256 / 32; i++)
+    {
+        changed_bits[i] = 0;
+    }
+    changed_head = 0;
+    changed_count = 0;
+
+    opl2_write(OPL2_TEST, OPL2_WAVE_SELECT);
+    chip[OPL2_TEST] = wanted[OPL2_TEST] = OPL2_WAVE_SELECT;
+
+    for (int c = 0; c < OPL2_CHANNELS; c++)
+    {
+        remaining_ms[c] = 0;
+        pending[c].waiting = false;
+    }
+
+    active = true;
+    return true;
+}
+
+bool opl2_active()
+{
+    return active;
+}
+
+/* ============================================================================
+ * NOTES (INTERRUPT)
+ * ============================================================================
+ */
+
+void opl2_set_instrument(int channel, int instrument)
+{
+    if (channel < 0 || channel >= OPL2_CHANNELS || instrument < 0 || instrument >= OPL2_INSTRUMENTS)
+    {
+        return;
+    }
+
+    const opl2_patch_t* patch = &patches[instrument];
+    uint8_t op = channel_operators[channel];
+
+    for (int o = 0; o < 2; o++)
+    {
+        uint8_t offset = op + o * 3;
+        opl2_set(OPL2_CHARACTER + offset, patch->character[o]);
+        opl2_set(OPL2_LEVEL + offset, patch->level[o]);
+        opl2_set(OPL2_ATTACK_DECAY + offset, patch->attack_decay[o]);
+        opl2_set(OPL2_SUSTAIN_RELEASE + offset, patch->sustain_release[o]);
+        opl2_set(OPL2_WAVEFORM + offset, patch->waveform[o]);
+    }
+    opl2_set(OPL2_FEEDBACK + channel, patch->feedback);
+}
+
+void opl2_note(int channel, uint16_t frequency, uint16_t duration_ms)
+{
+    if (channel < 0 || channel >= OPL2_CHANNELS)
+    {
+        return;
+    }
+
+    // ADDED: Whatever comes next, the playing note (if any) is let go
+    opl2_set(OPL2_KEY_BLOCK + channel, wanted[OPL2_KEY_BLOCK + channel] & ~OPL2_KEY_ON);
+    remaining_ms[channel] = 0;
+    pending[channel].waiting = false;
+
+    if (frequency == 0 || duration_ms == 0)
+    {
+        return;
+    }
+
+    // ADDED: F-number = frequency * 2^(20 - block) / 49716, under 1024 in
+    // the lowest block that fits (the most precise). Written as
+    // 2^(19 - block) / 24858 so it stays in 32 bits up to 8191 Hz.
+    uint32_t fnumber = 0;
+    int block = 0;
+    for (; block < 8; block++)
+    {
+        fnumber = ((uint32_t)frequency << (19 - block)) / (OPL2_SAMPLE_RATE / 2);
+        if (fnumber < 1024)
+        {
+            break;
+        }
+    }
+    if (block == 8)
+    {
+        return;
+    }
+
+    // ADDED: Keyed on by opl2_tick once the chip has the key off
+    pending[channel].fnumber = (uint16_t)fnumber;
+    pending[channel].block = (uint8_t)block;
+    pending[channel].duration_ms = duration_ms;
+    pending[channel].waiting = true;
+}
+
+// ADDED: Start each waiting note once its key off has been sent (and
+// nothing for the key register is still queued, so the F-number queued
+// now goes out first)
+static void opl2_start_notes()
+{
+    for (int c = 0; c < OPL2_CHANNELS; c++)
+    {
+        opl2_pending_t* note = &pending[c];
+        if (note->waiting && !(chip[OPL2_KEY_BLOCK + c] & OPL2_KEY_ON) &&
+            !opl2_queued(OPL2_KEY_BLOCK + c))
+        {
+            opl2_set(OPL2_FNUMBER_LOW + c, (uint8_t)(note->fnumber & 0xFF));
+            opl2_set(OPL2_KEY_BLOCK + c, OPL2_KEY_ON | (note->block << 2) | (uint8_t)(note->fnumber >> 8));
+            remaining_ms[c] = note->duration_ms;
+            note->waiting = false;
+        }
+    }
+}
+
+void opl2_tick()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    for (int c = 0; c < OPL2_CHANNELS; c++)
+    {
+        if (remaining_ms[c] > 0 && --remaining_ms[c] == 0)
+        {
+            opl2_set(OPL2_KEY_BLOCK + c, wanted[OPL2_KEY_BLOCK + c] & ~OPL2_KEY_ON);
+        }
+    }
+
+    opl2_start_notes();
+}
+
+/* ============================================================================
+ * SENDING (MAIN LOOP)
+ * ============================================================================
+ */
+
+void opl2_update()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    // ADDED: Key offs first, then the notes waiting on them go out in the
+    // same call instead of a frame later
+    opl2_flush();
+    disable_interrupts();
+    opl2_start_notes();
+    enable_interrupts();
+    opl2_flush();
+}
+
+void opl2_silence()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    disable_interrupts();
+    for (int c = 0; c < OPL2_CHANNELS; c++)
+    {
+        opl2_set(OPL2_KEY_BLOCK + c, wanted[OPL2_KEY_BLOCK + c] & ~OPL2_KEY_ON);
+        remaining_ms[c] = 0;
+        pending[c].waiting = false;
+    }
+    enable_interrupts();
+    opl2_flush();
+}
@@ -0,0 +1,48 @@
+#ifndef OPL2_H
+#define OPL2_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: AdLib / OPL2 FM synthesis (ports 0x388-0x389), used for the
+// music while the PC speaker keeps playing the effects.
+//
+// The chip needs a pause after every register write and each pause costs
+// dozens of slow port reads (about 40 us a register), too long for the
+// timer interrupt, which runs every 62.5 us during PCM playback. So the
+// interrupt only changes a shadow copy of the registers, and the game loop
+// calls opl2_update() to send the ones that ended up different from what
+// the chip already has, oldest first.
+//
+// Under QEMU: -device adlib (with an -audiodev, e.g.
+// -audiodev pa,id=snd0 -machine pcspk-audiodev=snd0 -device adlib,audiodev=snd0)
+
+#define OPL2_CHANNELS 9
+
+// ADDED: Built-in instruments (opl2_set_instrument)
+#define OPL2_INSTRUMENT_PIANO   0
+#define OPL2_INSTRUMENT_BASS    1
+#define OPL2_INSTRUMENT_ORGAN   2
+#define OPL2_INSTRUMENT_SQUARE  3
+#define OPL2_INSTRUMENT_BELL    4
+#define OPL2_INSTRUMENTS        5
+
+// ADDED: Detect and reset the chip; false if there is none
+bool opl2_init();
+bool opl2_active();
+
+// ADDED: Interrupt context (the music sequencer). Reach the chip on the
+// next opl2_update.
+void opl2_set_instrument(int channel, int instrument);
+void opl2_note(int channel, uint16_t frequency, uint16_t duration_ms);   // 0 Hz = key off
+
+// ADDED: Called by the timer interrupt every millisecond: ends notes whose
+// time is up and starts waiting ones, in the shadow only
+void opl2_tick();
+
+// ADDED: Main loop. Send the changed registers (once per frame is enough),
+// or key off every channel now, e.g. when the game stops calling update.
+void opl2_update();
+void opl2_silence();
+
+#endif
@@ -0,0 +1,124 @@
+#include "pcm.h"
+#include "mixer.h"
+#include "io/io.h"
+#include "timer/timer.h"
+#include "idt/idt.h"
+
+// ADDED: PIT and speaker ports (see speaker.c)
+#define PIT_FREQUENCY   1193182
+#define PIT_COMMAND     0x43
+#define PIT_CHANNEL_2   0x42
+#define SPEAKER_PORT    0x61
+
+// ADDED: Sample period in PIT clocks; a pulse is 1 to PCM_PERIOD - 1 long
+#define PCM_PERIOD      (PIT_FREQUENCY / PCM_RATE)
+
+static bool active = false;
+static bool speaker_on = false;
+
+// ADDED: Pulse length for each 8-bit level (the mixed sample's top byte
+// + 128), worked out once so the interrupt doesn't divide
+static uint8_t pulse_counts[256];
+
+// ADDED: Interrupt cost, collected by pcm_take_isr_cycles
+static volatile uint32_t isr_cycles = 0;
+static volatile uint32_t isr_count = 0;
+static volatile uint32_t isr_max = 0;
+
+static inline uint32_t pcm_timestamp()
+{
+    uint32_t low, high;
+    __asm__ volatile ("rdtsc" : "=a"(low), "=d"(high));
+    return low;
+}
+
+// ADDED: IRQ0 callback - play one mixed sample as a pulse
+static void pcm_sample()
+{
+    uint32_t start = pcm_timestamp();
+    int sample;
+
+    if (!mixer_sample(&sample))
+    {
+        // ADDED: Nothing to play - let go of the speaker rather than hold
+        // it at a steady 50% (a faint whine on real speakers)
+        if (speaker_on)
+        {
+            outb(SPEAKER_PORT, insb(SPEAKER_PORT) & 0xFC);
+            speaker_on = false;
+        }
+    }
+    else
+    {
+        if (!speaker_on)
+        {
+            outb(SPEAKER_PORT, insb(SPEAKER_PORT) | 0x03);
+            speaker_on = true;
+        }
+
+        outb(PIT_CHANNEL_2, pulse_counts[(sample >> 8) + 128]);
+    }
+
+    uint32_t cycles = pcm_timestamp() - start;
+    isr_cycles += cycles;
+    isr_count++;
+    if (cycles > isr_max)
+    {
+        isr_max = cycles;
+    }
+}
+
+void pcm_init()
+{
+    if (active)
+    {
+        return;
+    }
+
+    // ADDED: Mode 0 output stays low for the count, then goes high for the
+    // rest of the period, so the louder the sample the shorter the count
+    for (int level = 0; level < 256; level++)
+    {
+        pulse_counts[level] = (uint8_t)(1 + (255 - level) * (PCM_PERIOD - 2) / 255);
+    }
+
+    // ADDED: Channel 2, lobyte only, mode 0 (one pulse per count written)
+    outb(PIT_COMMAND, 0x90);
+    outb(PIT_CHANNEL_2, PCM_PERIOD / 2);
+
+    active = true;
+    mixer_start(PIT_FREQUENCY / PCM_PERIOD);
+    timer_set_rate(PCM_RATE, pcm_sample);
+}
+
+void pcm_shutdown()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    timer_set_rate(0, 0);
+    mixer_shutdown();
+    active = false;
+
+    outb(SPEAKER_PORT, insb(SPEAKER_PORT) & 0xFC);
+    speaker_on = false;
+}
+
+bool pcm_active()
+{
+    return active;
+}
+
+void pcm_take_isr_cycles(uint32_t* avg, uint32_t* max)
+{
+    // ADDED: Read and reset together, without a sample landing in between
+    disable_interrupts();
+    *avg = isr_count ? isr_cycles / isr_count : 0;
+    *max = isr_max;
+    isr_cycles = 0;
+    isr_count = 0;
+    isr_max = 0;
+    enable_interrupts();
+}
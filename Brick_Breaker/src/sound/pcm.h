@@ -0,0 +1,27 @@
+#ifndef PCM_H
+#define PCM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: PCM sample playback on the PC speaker. pcm_init() moves IRQ0 to
+// the sample rate (the millisecond ticks carry on, see timer_set_rate).
+// Every interrupt takes one sample from the mixer (sound/mixer.h) and
+// sends it to the speaker as one pulse of PIT channel 2 (1-bit PWM): the
+// louder the sample, the longer the speaker is pushed out during that
+// sample. Sounds are queued through the mixer.
+
+// ADDED: Interrupts per second. The PIT divisor (74) is also the number of
+// pulse widths, so samples are played with about 6 bits of resolution.
+#define PCM_RATE 16000
+
+// ADDED: Take over IRQ0 and PIT channel 2; pcm_shutdown gives them back
+void pcm_init();
+void pcm_shutdown();
+bool pcm_active();
+
+// ADDED: Average and peak CPU cycles one sample interrupt took since the
+// last call (both 0 if PCM is off)
+void pcm_take_isr_cycles(uint32_t* avg, uint32_t* max);
+
+#endif
@@ -0,0 +1,255 @@
+#include "sb16.h"
+#include "mixer.h"
+#include "io/io.h"
+
+// ADDED: DSP ports, relative to the base port
+#define DSP_MIXER_ADDRESS   0x04
+#define DSP_MIXER_DATA      0x05
+#define DSP_RESET           0x06
+#define DSP_READ            0x0A
+#define DSP_WRITE           0x0C    // Bit 7 of a read = busy
+#define DSP_READ_STATUS     0x0E    // Bit 7 = data waiting; reading acks 8-bit IRQs
+#define DSP_ACK_16          0x0F    // Reading acks 16-bit IRQs
+
+// ADDED: DSP commands
+#define DSP_SET_RATE        0x41
+#define DSP_PLAY_16         0xB6    // 16-bit, D/A, auto-init, FIFO on
+#define DSP_PLAY_8          0xC6    // 8-bit, D/A, auto-init, FIFO on
+#define DSP_STOP_8          0xDA    // Exit 8-bit auto-init
+#define DSP_STOP_16         0xD9    // Exit 16-bit auto-init
+#define DSP_VERSION         0xE1
+
+// ADDED: Mode bytes after DSP_PLAY_*
+#define DSP_MODE_MONO_UNSIGNED  0x00
+#define DSP_MODE_MONO_SIGNED    0x10
+
+// ADDED: Mixer registers choosing the IRQ and DMA channels
+#define MIXER_IRQ           0x80
+#define MIXER_DMA           0x81
+#define MIXER_IRQ_5         0x02
+#define MIXER_DMA_1_5       0x22    // 8-bit on DMA 1, 16-bit on DMA 5
+
+// ADDED: Reads of a status port before the card counts as not answering
+#define DSP_TIMEOUT         65536
+
+#define SB16_PIC_MASK       0x21
+#define SB16_IRQ_BIT        (1 << 5)
+
+// ADDED: Both halves, 16-bit at most. Aligned to its own size, so it never
+// crosses the 64K boundary the DMA controller can't count past; the
+// kernel lives below 16MB and is identity mapped, so the ISA DMA can
+// reach it at its own address.
+#define SB16_BUFFER_BYTES   (SB16_HALF_SAMPLES * 2 * 2)
+static uint8_t dma_buffer[SB16_BUFFER_BYTES] __attribute__((aligned(SB16_BUFFER_BYTES)));
+
+static uint16_t base = 0;
+static bool active = false;
+static bool sixteen_bit = true;
+static int next_half = 0;     // Half the card plays next once the current one ends
+
+/* ============================================================================
+ * DSP
+ * ============================================================================
+ */
+
+static bool dsp_write(uint8_t value)
+{
+    for (int i = 0; i < DSP_TIMEOUT; i++)
+    {
+        if (!(insb(base + DSP_WRITE) & 0x80))
+        {
+            outb(base + DSP_WRITE, value);
+            return true;
+        }
+    }
+    return false;
+}
+
+static int dsp_read()
+{
+    for (int i = 0; i < DSP_TIMEOUT; i++)
+    {
+        if (insb(base + DSP_READ_STATUS) & 0x80)
+        {
+            return insb(base + DSP_READ);
+        }
+    }
+    return -1;
+}
+
+// ADDED: A DSP answers a reset with 0xAA
+static bool dsp_reset()
+{
+    outb(base + DSP_RESET, 1);
+    // ADDED: Hold reset for at least 3 us (each port read takes about 1 us)
+    for (int i = 0; i < 8; i++)
+    {
+        insb(base + DSP_RESET);
+    }
+    outb(base + DSP_RESET, 0);
+
+    return dsp_read() == 0xAA;
+}
+
+static void mixer_register(uint8_t index, uint8_t value)
+{
+    outb(base + DSP_MIXER_ADDRESS, index);
+    outb(base + DSP_MIXER_DATA, value);
+}
+
+/* ============================================================================
+ * ISA DMA
+ * ============================================================================
+ * Single-cycle mode, auto-init, memory to card (mode byte 0x59 + channel).
+ */
+
+// ADDED: 8-bit channel 1: address and count in bytes
+static void dma_start_8(uint32_t address, uint32_t bytes)
+{
+    outb(0x0A, 0x05);                          // Mask channel 1
+    outb(0x0C, 0x00);                          // Reset the byte flip-flop
+    outb(0x0B, 0x59);
+    outb(0x02, (uint8_t)(address & 0xFF));
+    outb(0x02, (uint8_t)((address >> 8) & 0xFF));
+    outb(0x83, (uint8_t)((address >> 16) & 0xFF));   // Page
+    outb(0x03, (uint8_t)((bytes - 1) & 0xFF));
+    outb(0x03, (uint8_t)(((bytes - 1) >> 8) & 0xFF));
+    outb(0x0A, 0x01);                          // Unmask
+}
+
+// ADDED: 16-bit channel 5: address and count in 16-bit words
+static void dma_start_16(uint32_t address, uint32_t bytes)
+{
+    uint32_t offset = (address >> 1) & 0xFFFF;
+    uint32_t words = bytes / 2;
+
+    outb(0xD4, 0x05);                          // Mask channel 5
+    outb(0xD8, 0x00);                          // Reset the byte flip-flop
+    outb(0xD6, 0x59);
+    outb(0xC4, (uint8_t)(offset & 0xFF));
+    outb(0xC4, (uint8_t)((offset >> 8) & 0xFF));
+    outb(0x8B, (uint8_t)((address >> 16) & 0xFF));   // Page
+    outb(0xC6, (uint8_t)((words - 1) & 0xFF));
+    outb(0xC6, (uint8_t)(((words - 1) >> 8) & 0xFF));
+    outb(0xD4, 0x01);                          // Unmask
+}
+
+/* ============================================================================
+ * PLAYBACK
+ * ============================================================================
+ */
+
+// ADDED: Mix one half of the buffer
+static void fill_half(int half)
+{
+    if (sixteen_bit)
+    {
+        mixer_render16((int16_t*)dma_buffer + half * SB16_HALF_SAMPLES, SB16_HALF_SAMPLES);
+    }
+    else
+    {
+        mixer_render8(dma_buffer + half * SB16_HALF_SAMPLES, SB16_HALF_SAMPLES);
+    }
+}
+
+void sb16_irq_handler()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    // ADDED: Acknowledge the card (the wrapper sends the PIC its EOI)
+    insb(base + (sixteen_bit ? DSP_ACK_16 : DSP_READ_STATUS));
+
+    // ADDED: The card has moved on to the other half; refill this one
+    fill_half(next_half);
+    next_half ^= 1;
+}
+
+bool sb16_init(int bits)
+{
+    static const uint16_t bases[] = { 0x220, 0x240, 0x260, 0x280 };
+
+    if (active)
+    {
+        return true;
+    }
+
+    base = 0;
+    for (int i = 0; i < (int)(sizeof(bases) / sizeof(bases[0])) && !base; i++)
+    {
+        base = bases[i];
+        if (!dsp_reset())
+        {
+            base = 0;
+        }
+    }
+    if (!base)
+    {
+        return false;
+    }
+
+    // ADDED: DSP 4.x = SB16; older cards can't do 16-bit or DSP_SET_RATE
+    dsp_write(DSP_VERSION);
+    int major = dsp_read();
+    dsp_read();
+    if (major < 4)
+    {
+        return false;
+    }
+
+    sixteen_bit = (bits == 16);
+    mixer_register(MIXER_IRQ, MIXER_IRQ_5);
+    mixer_register(MIXER_DMA, MIXER_DMA_1_5);
+    outb(SB16_PIC_MASK, insb(SB16_PIC_MASK) & ~SB16_IRQ_BIT);
+
+    // ADDED: Start from silence in both halves
+    mixer_start(SB16_RATE);
+    fill_half(0);
+    fill_half(1);
+    next_half = 0;
+    active = true;
+
+    uint32_t address = (uint32_t)dma_buffer;
+    uint32_t half_count = SB16_HALF_SAMPLES - 1;
+    if (sixteen_bit)
+    {
+        dma_start_16(address, SB16_HALF_SAMPLES * 2 * 2);
+    }
+    else
+    {
+        dma_start_8(address, SB16_HALF_SAMPLES * 2);
+    }
+
+    dsp_write(DSP_SET_RATE);
+    dsp_write((uint8_t)(SB16_RATE >> 8));
+    dsp_write((uint8_t)(SB16_RATE & 0xFF));
+
+    // ADDED: The DSP is told the length of one half, so it interrupts
+    // twice per pass over the buffer
+    dsp_write(sixteen_bit ? DSP_PLAY_16 : DSP_PLAY_8);
+    dsp_write(sixteen_bit ? DSP_MODE_MONO_SIGNED : DSP_MODE_MONO_UNSIGNED);
+    dsp_write((uint8_t)(half_count & 0xFF));
+    dsp_write((uint8_t)((half_count >> 8) & 0xFF));
+
+    return true;
+}
+
+void sb16_shutdown()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    dsp_write(sixteen_bit ? DSP_STOP_16 : DSP_STOP_8);
+    outb(SB16_PIC_MASK, insb(SB16_PIC_MASK) | SB16_IRQ_BIT);
+    mixer_shutdown();
+    active = false;
+}
+
+bool sb16_active()
+{
+    return active;
+}
@@ -0,0 +1,29 @@
+#ifndef SB16_H
+#define SB16_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Sound Blaster 16 driver. The card plays a DMA buffer in a loop
+// (auto-init DMA) and raises IRQ 5 each time it finishes one half; the
+// interrupt then has the mixer (sound/mixer.h) fill that half again while
+// the card plays the other one. No CPU time goes into sound in between.
+//
+// Under QEMU: -device sb16 (the defaults, port 0x220, IRQ 5, DMA 1/5,
+// are what this driver sets up).
+
+#define SB16_RATE 22050
+
+// ADDED: Samples in each half of the DMA buffer (about 12 ms)
+#define SB16_HALF_SAMPLES 256
+
+// ADDED: Find and start the card, playing bits-bit (8 or 16) mono samples.
+// Returns false if there is no SB16, and the other backends stay in use.
+bool sb16_init(int bits);
+void sb16_shutdown();
+bool sb16_active();
+
+// ADDED: Called by the IRQ 5 wrapper in idt.asm
+void sb16_irq_handler();
+
+#endif
@@ -0,0 +1,162 @@
+#include "speaker.h"
+#include "io/io.h"
+#include "mixer.h"
+
+// ADDED: PIT channel 2 drives the speaker; port 0x61 bits 0-1 gate it
+#define PIT_FREQUENCY   1193182
+#define PIT_COMMAND     0x43
+#define PIT_CHANNEL_2   0x42
+#define SPEAKER_PORT    0x61
+
+// ADDED: Queued request for speaker_stop (not a real priority)
+#define SPEAKER_STOP_ALL SPEAKER_PRIORITIES
+
+typedef struct {
+    uint16_t frequency;
+    uint16_t duration_ms;
+    uint8_t priority;
+} speaker_request_t;
+
+typedef struct {
+    uint16_t frequency;
+    uint16_t remaining_ms;  // 0 = not playing
+} speaker_voice_t;
+
+// ADDED: Filled by the game, emptied by the interrupt. Only the game moves
+// the tail and only the interrupt moves the head, so no locking is needed.
+static speaker_request_t speaker_queue[SPEAKER_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0;
+static volatile uint32_t queue_tail = 0;
+
+// ADDED: Owned by the interrupt
+static speaker_voice_t voices[SPEAKER_PRIORITIES];
+static uint16_t speaker_frequency = 0;   // What the speaker is playing (0 = off)
+static uint16_t mixer_frequency[SPEAKER_PRIORITIES];   // Tones given to the mixer
+static bool was_mixing = false;
+
+static void speaker_queue_request(uint16_t frequency, uint16_t duration_ms, uint8_t priority)
+{
+    uint32_t tail = queue_tail;
+    if (tail - queue_head == SPEAKER_QUEUE_SIZE)
+    {
+        return;
+    }
+
+    speaker_request_t* request = &speaker_queue[tail & (SPEAKER_QUEUE_SIZE - 1)];
+    request->frequency = frequency;
+    request->duration_ms = duration_ms;
+    request->priority = priority;
+
+    // ADDED: The request must be written before the interrupt can see it
+    __asm__ volatile ("" ::: "memory");
+    queue_tail = tail + 1;
+}
+
+void speaker_play(uint16_t frequency, uint16_t duration_ms, speaker_priority_t priority)
+{
+    if (priority < SPEAKER_PRIORITIES)
+    {
+        speaker_queue_request(frequency, duration_ms, priority);
+    }
+}
+
+void speaker_set(uint16_t frequency, uint16_t duration_ms, speaker_priority_t priority)
+{
+    if (priority < SPEAKER_PRIORITIES)
+    {
+        voices[priority].frequency = frequency;
+        voices[priority].remaining_ms = duration_ms;
+    }
+}
+
+void speaker_stop()
+{
+    speaker_queue_request(0, 0, SPEAKER_STOP_ALL);
+}
+
+// ADDED: Program the speaker - only called when the tone actually changes
+static void speaker_output(uint16_t frequency)
+{
+    if (frequency == 0)
+    {
+        outb(SPEAKER_PORT, insb(SPEAKER_PORT) & 0xFC);
+        return;
+    }
+
+    uint32_t divisor = PIT_FREQUENCY / frequency;
+
+    // ADDED: Channel 2, lobyte/hibyte, square wave
+    outb(PIT_COMMAND, 0xB6);
+    outb(PIT_CHANNEL_2, (uint8_t)(divisor & 0xFF));
+    outb(PIT_CHANNEL_2, (uint8_t)((divisor >> 8) & 0xFF));
+    outb(SPEAKER_PORT, insb(SPEAKER_PORT) | 0x03);
+}
+
+void speaker_tick()
+{
+    // ADDED: Take new requests in the order they were made
+    while (queue_head != queue_tail)
+    {
+        const speaker_request_t* request = &speaker_queue[queue_head & (SPEAKER_QUEUE_SIZE - 1)];
+
+        if (request->priority == SPEAKER_STOP_ALL)
+        {
+            for (int p = 0; p < SPEAKER_PRIORITIES; p++)
+            {
+                voices[p].remaining_ms = 0;
+            }
+        }
+        else
+        {
+            voices[request->priority].frequency = request->frequency;
+            voices[request->priority].remaining_ms = request->duration_ms;
+        }
+        queue_head++;
+    }
+
+    // ADDED: Every voice counts down; the highest one still playing is heard
+    uint16_t frequency = 0;
+    bool mixing = mixer_active();
+    if (mixing != was_mixing)
+    {
+        // ADDED: A (re)started mixer has all its tones off
+        for (int p = 0; p < SPEAKER_PRIORITIES; p++)
+        {
+            mixer_frequency[p] = 0;
+        }
+        was_mixing = mixing;
+    }
+    for (int p = 0; p < SPEAKER_PRIORITIES; p++)
+    {
+        uint16_t voice_frequency = 0;
+        if (voices[p].remaining_ms > 0)
+        {
+            voices[p].remaining_ms--;
+            voice_frequency = voices[p].frequency;
+        }
+
+        if (voice_frequency != 0)
+        {
+            frequency = voice_frequency;
+        }
+
+        // ADDED: A sample backend can play every priority at once, each
+        // on its own mixer tone
+        if (mixing && voice_frequency != mixer_frequency[p])
+        {
+            mixer_set_tone(p, voice_frequency);
+            mixer_frequency[p] = voice_frequency;
+        }
+    }
+
+    if (mixing)
+    {
+        return;
+    }
+
+    if (frequency != speaker_frequency)
+    {
+        speaker_output(frequency);
+        speaker_frequency = frequency;
+    }
+}
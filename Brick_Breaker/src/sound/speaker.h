@@ -0,0 +1,39 @@
+#ifndef SPEAKER_H
+#define SPEAKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: PC speaker sound scheduler. Tones are queued by the caller and
+// started, timed and stopped by the timer interrupt, so queueing one never
+// touches an I/O port and every tone lasts exactly as long as asked.
+// While a sample backend runs the mixer (sound/mixer.h), the tones are
+// played there instead, every priority at once.
+
+// ADDED: Tone priorities. While a higher one sounds, lower ones keep
+// counting down silently and are heard again if they outlast it.
+typedef enum {
+    SPEAKER_MUSIC = 0,
+    SPEAKER_EFFECT,
+    SPEAKER_PRIORITIES
+} speaker_priority_t;
+
+// ADDED: Requests waiting for the next tick (power of two). The interrupt
+// empties the queue every millisecond; requests that don't fit are dropped.
+#define SPEAKER_QUEUE_SIZE 16
+
+// ADDED: Play a tone for duration_ms, replacing whatever that priority was
+// playing (frequency 0 silences it)
+void speaker_play(uint16_t frequency, uint16_t duration_ms, speaker_priority_t priority);
+
+// ADDED: speaker_play for code already in the timer interrupt (the music
+// sequencer): sets the voice straight away instead of queueing
+void speaker_set(uint16_t frequency, uint16_t duration_ms, speaker_priority_t priority);
+
+// ADDED: Silence every priority, including tones queued before this call
+void speaker_stop();
+
+// ADDED: Called by the timer interrupt every millisecond
+void speaker_tick();
+
+#endif
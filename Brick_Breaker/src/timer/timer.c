@@ -1,6 +1,9 @@
 #include "timer.h"
 #include "io/io.h"
 #include "idt/idt.h"
+#include "sound/speaker.h"  // ADDED: Tones are timed from this interrupt
+#include "sound/music.h"    // ADDED: And the music sequenced
+#include "sound/opl2.h"     // ADDED: And sent to the AdLib
 
 // Global tick counter (incremented by IRQ0 handler)
 // ADDED: volatile tells compiler this can change at any time (from interrupt)
@@ -10,29 +13,90 @@ static volatile uint32_t g_timer_ticks = 0;
 #define PIT_FREQUENCY 1193182
 #define TARGET_FREQUENCY 1000  // 1000 Hz = 1 tick per millisecond
 
+// ADDED: Fast mode (timer_set_rate): the callback runs on every interrupt,
+// and each interrupt adds divisor * 1000 to the accumulator, so a tick is
+// due every PIT_FREQUENCY of it - exactly one per millisecond on average
+static void (*volatile g_fast_callback)() = 0;
+static volatile uint32_t g_fast_step = 0;
+static uint32_t g_fast_accumulator = 0;
+
+// ADDED: One millisecond has passed
+static void timer_tick()
+{
+    g_timer_ticks++;
+    // ADDED: Next note of the music, if one is due
+    music_tick();
+    // ADDED: End AdLib notes that are up (the game loop sends the registers)
+    opl2_tick();
+    // ADDED: Start, time and stop queued speaker tones
+    speaker_tick();
+}
+
 // ADDED: This function is called by the IRQ0 assembly wrapper
 void timer_handler()
 {
-    g_timer_ticks++;
+    void (*callback)() = g_fast_callback;
+
+    if (!callback)
+    {
+        timer_tick();
+    }
+    else
+    {
+        callback();
+
+        g_fast_accumulator += g_fast_step;
+        if (g_fast_accumulator >= PIT_FREQUENCY)
+        {
+            g_fast_accumulator -= PIT_FREQUENCY;
+            timer_tick();
+        }
+    }
     // ADDED: Send End-Of-Interrupt signal to PIC
     outb(0x20, 0x20);
 }
 
-void timer_init()
+// ADDED: Program channel 0 to fire IRQ0 every divisor PIT clocks
+static void timer_program(uint32_t divisor)
 {
-    // ADDED: Calculate divisor for desired frequency
-    uint32_t divisor = PIT_FREQUENCY / TARGET_FREQUENCY;
-    
     // ADDED: Send command byte to PIT (Channel 0, Mode 3 - square wave)
     outb(0x43, 0x36);
     
     // ADDED: Send divisor (low byte, then high byte)
     outb(0x40, (uint8_t)(divisor & 0xFF));
     outb(0x40, (uint8_t)((divisor >> 8) & 0xFF));
+}
+
+void timer_init()
+{
+    // ADDED: Calculate divisor for desired frequency
+    timer_program(PIT_FREQUENCY / TARGET_FREQUENCY);
     
     // Timer will now fire IRQ0 at 1000 Hz
 }
 
+void timer_set_rate(uint32_t hz, void (*callback)())
+{
+    // ADDED: Switched with interrupts off, so the handler never sees half
+    disable_interrupts();
+
+    if (!callback || hz <= TARGET_FREQUENCY)
+    {
+        g_fast_callback = 0;
+        timer_program(PIT_FREQUENCY / TARGET_FREQUENCY);
+    }
+    else
+    {
+        uint32_t divisor = PIT_FREQUENCY / hz;
+        g_fast_step = divisor * 1000;
+        g_fast_accumulator = 0;
+        g_fast_callback = callback;
+        timer_program(divisor);
+    }
+
+    enable_interrupts();
+}
+
 uint32_t timer_get_ticks()
 {
     return g_timer_ticks;
@@ -6,6 +6,11 @@
 // Initialize PIT (Programmable Interval Timer) to 1000 Hz (1ms ticks)
 void timer_init();
 
+// ADDED: Run IRQ0 at hz instead (e.g. an audio sample rate) and call
+// callback on every interrupt; the millisecond ticks are still counted.
+// callback 0 goes back to plain 1000 Hz.
+void timer_set_rate(uint32_t hz, void (*callback)());
+
 // Get milliseconds since boot
 uint32_t timer_get_ticks();
 